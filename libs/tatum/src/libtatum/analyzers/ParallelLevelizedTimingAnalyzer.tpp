@@ -41,7 +41,7 @@ void ParallelLevelizedTimingAnalyzer<AnalysisType, DelayCalcType>::forward_trave
     using namespace std::chrono;
 
     //Forward traversal (arrival times)
-    for(LevelId level_id = 1; level_id < this->tg_.num_levels(); level_id++) {
+    for(LevelId level_id = this->first_fwd_level_; level_id < this->tg_.num_levels(); level_id++) {
         auto fwd_level_start = high_resolution_clock::now();
 
         const std::vector<NodeId>& level = this->tg_.level(level_id);
@@ -62,6 +62,10 @@ void ParallelLevelizedTimingAnalyzer<AnalysisType, DelayCalcType>::forward_trave
 
         }
 
+        if(this->level_callback_) {
+            this->level_callback_(level_id);
+        }
+
         auto fwd_level_end = high_resolution_clock::now();
         std::string key = std::string("fwd_level_") + std::to_string(level_id);
         this->perf_data_[key] = duration_cast<duration<double>>(fwd_level_end - fwd_level_start).count();
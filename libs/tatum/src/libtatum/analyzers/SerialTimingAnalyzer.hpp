@@ -1,5 +1,6 @@
 #pragma once
 #include <chrono>
+#include <functional>
 #include <string>
 
 #include "TimingAnalyzer.hpp"
@@ -34,6 +35,13 @@
  * backward_traverse_node() functions.  The actual work performed will vary depending upon
  * which mix-in class is specified as the AnalysisType template parameter.
  *
+ * Resuming
+ * ==========
+ * A level callback (see set_level_callback()) is called as each level of the forward traversal
+ * completes, at which point the tags of all nodes in that and earlier levels are final.  A callback
+ * may save them (e.g. to checkpoint a long analysis), and once restored into a new analyzer
+ * resume_timing() completes the analysis from the following level.
+ *
  * Thread-saftey
  * ==============
  * NOTE: forward_traverse_node() and backward_traverse_node() should be thread-safe,
@@ -55,6 +63,19 @@ class SerialTimingAnalyzer : public TimingAnalyzer<AnalysisType, DelayCalcType>
         SerialTimingAnalyzer(const TimingGraph& timing_graph, const TimingConstraints& timing_constraints, const DelayCalcType& delay_calculator, const TagReducer& tag_reducer, size_t max_permutations=0);
         void calculate_timing() override;
         void reset_timing() override;
+
+        ///Completes an analysis whose forward traversal stopped before first_level, skipping the
+        ///pre-traversal and the earlier levels.  The tags of all nodes in the earlier levels must
+        ///already have been restored.
+        /// \param first_level The first level of the forward traversal to evaluate
+        void resume_timing(const LevelId first_level);
+
+        ///Called with the id of each level of the forward traversal once it is complete
+        typedef std::function<void(LevelId)> LevelCallback;
+
+        ///\param callback The function to call after each level of the forward traversal (may be empty)
+        void set_level_callback(LevelCallback callback) { level_callback_ = callback; }
+
         const DelayCalcType& delay_calculator() override { return dc_; }
         std::map<std::string, double> profiling_data() override { return perf_data_; }
     protected:
@@ -76,6 +97,10 @@ class SerialTimingAnalyzer : public TimingAnalyzer<AnalysisType, DelayCalcType>
         /// \param node_id The node to process
         void backward_traverse_node(const NodeId node_id);
 
+        ///Prints tag and permutation statistics for a completed level of the forward traversal
+        /// \param level_id The level to report on
+        void print_level_stats(const LevelId level_id);
+
         /*
          * Data
          */
@@ -85,6 +110,9 @@ class SerialTimingAnalyzer : public TimingAnalyzer<AnalysisType, DelayCalcType>
         const TagReducer& tag_reducer_;
         size_t max_permutations_;
 
+        LevelId first_fwd_level_; //The level the forward traversal starts at
+        LevelCallback level_callback_; //Called after each level of the forward traversal
+
         std::map<std::string, double> perf_data_; //Performance profiling info, assumes each data point has a unique string identifier
 };
 
@@ -7,7 +7,8 @@ SerialTimingAnalyzer<AnalysisType,DelayCalcType>::SerialTimingAnalyzer(const Tim
     , tc_(tc)
     , dc_(dc)
     , tag_reducer_(tag_reducer)
-    , max_permutations_(max_permutations) {
+    , max_permutations_(max_permutations)
+    , first_fwd_level_(1) {
     AnalysisType::initialize_traversal(tg_);
 }
 
@@ -38,6 +39,32 @@ void SerialTimingAnalyzer<AnalysisType,DelayCalcType>::calculate_timing() {
     perf_data_["bck_traversal"] = duration_cast<duration<double>>(bck_traversal_end - bck_traversal_start).count();
 }
 
+template<class AnalysisType, class DelayCalcType>
+void SerialTimingAnalyzer<AnalysisType,DelayCalcType>::resume_timing(const LevelId first_level) {
+    using namespace std::chrono;
+
+    auto analysis_start = high_resolution_clock::now();
+
+    //The primary inputs (level 0) were initialized by the interrupted analysis
+    first_fwd_level_ = std::max<LevelId>(first_level, 1);
+
+    auto fwd_traversal_start = high_resolution_clock::now();
+    forward_traversal();
+    auto fwd_traversal_end = high_resolution_clock::now();
+
+    first_fwd_level_ = 1;
+
+    auto bck_traversal_start = high_resolution_clock::now();
+    backward_traversal();
+    auto bck_traversal_end = high_resolution_clock::now();
+
+    auto analysis_end = high_resolution_clock::now();
+
+    perf_data_["analysis"] = duration_cast<duration<double>>(analysis_end - analysis_start).count();
+    perf_data_["fwd_traversal"] = duration_cast<duration<double>>(fwd_traversal_end - fwd_traversal_start).count();
+    perf_data_["bck_traversal"] = duration_cast<duration<double>>(bck_traversal_end - bck_traversal_start).count();
+}
+
 template<class AnalysisType, class DelayCalcType>
 void SerialTimingAnalyzer<AnalysisType,DelayCalcType>::reset_timing() {
     AnalysisType::initialize_traversal(tg_);
@@ -61,58 +88,26 @@ void SerialTimingAnalyzer<AnalysisType,DelayCalcType>::forward_traversal() {
     using namespace std::chrono;
 
     //Forward traversal (arrival times)
-    for(LevelId level_id = 1; level_id < tg_.num_levels(); level_id++) {
+    for(LevelId level_id = first_fwd_level_; level_id < tg_.num_levels(); level_id++) {
         auto fwd_level_start = high_resolution_clock::now();
 
         std::cout << "\tLevel " << level_id << " ";
         const auto& level = tg_.level(level_id);
 
-        double total_level_tags = 0.;
-        double min_level_tags = std::numeric_limits<double>::max();
-        double max_level_tags = 0.;
-
-        double total_permutations = 0.;
-        double min_permutations = std::numeric_limits<double>::max();
-        double max_permutations = 0.;
-
         for(size_t i = 0; i < level.size(); ++i) {
             std::cout << ".";
             std::cout.flush();
             NodeId node_id = level[i];
 
             forward_traverse_node(node_id);
-            
-            //Stats
-            total_level_tags += this->setup_data_tags_[node_id].num_tags();
-            min_level_tags = std::min(min_level_tags, (double) this->setup_data_tags_[node_id].num_tags());
-            max_level_tags = std::max(max_level_tags, (double) this->setup_data_tags_[node_id].num_tags());
-
-            double node_perms = 1.;
-            for(int iedge = 0; iedge < tg_.num_node_in_edges(node_id); iedge++) {
-                EdgeId edge_id = tg_.node_in_edge(node_id, iedge);
-                NodeId src_node_id = tg_.edge_src_node(edge_id);
-                
-                node_perms *= this->setup_data_tags_[src_node_id].num_tags();
-            }
-            total_permutations += node_perms;
-            min_permutations = std::min(min_permutations, node_perms);
-            max_permutations = std::max(max_permutations, node_perms);
         }
         std::cout << std::endl;
 
-        std::cout << "\tLevel " << level_id << " Tags:";
-        std::cout << " Avg: " << total_level_tags / level.size();
-        std::cout << " Min: " << min_level_tags;
-        std::cout << " Max: " << max_level_tags;
-        std::cout << std::endl;
-
-        std::cout << "\tLevel " << level_id << " Permutations:";
-        std::cout << " Total: " << total_permutations;
-        std::cout << " Avg: " << total_permutations / level.size();
-        std::cout << " Min: " << min_permutations;
-        std::cout << " Max: " << max_permutations;
-        std::cout << std::endl;
+        print_level_stats(level_id);
 
+        if(level_callback_) {
+            level_callback_(level_id);
+        }
 
         auto fwd_level_end = high_resolution_clock::now();
         std::string key = std::string("fwd_level_") + std::to_string(level_id);
@@ -120,6 +115,49 @@ void SerialTimingAnalyzer<AnalysisType,DelayCalcType>::forward_traversal() {
     }
 }
 
+template<class AnalysisType, class DelayCalcType>
+void SerialTimingAnalyzer<AnalysisType,DelayCalcType>::print_level_stats(const LevelId level_id) {
+    const auto& level = tg_.level(level_id);
+
+    double total_level_tags = 0.;
+    double min_level_tags = std::numeric_limits<double>::max();
+    double max_level_tags = 0.;
+
+    double total_permutations = 0.;
+    double min_permutations = std::numeric_limits<double>::max();
+    double max_permutations = 0.;
+
+    for(NodeId node_id : level) {
+        total_level_tags += this->setup_data_tags_[node_id].num_tags();
+        min_level_tags = std::min(min_level_tags, (double) this->setup_data_tags_[node_id].num_tags());
+        max_level_tags = std::max(max_level_tags, (double) this->setup_data_tags_[node_id].num_tags());
+
+        double node_perms = 1.;
+        for(int iedge = 0; iedge < tg_.num_node_in_edges(node_id); iedge++) {
+            EdgeId edge_id = tg_.node_in_edge(node_id, iedge);
+            NodeId src_node_id = tg_.edge_src_node(edge_id);
+            
+            node_perms *= this->setup_data_tags_[src_node_id].num_tags();
+        }
+        total_permutations += node_perms;
+        min_permutations = std::min(min_permutations, node_perms);
+        max_permutations = std::max(max_permutations, node_perms);
+    }
+
+    std::cout << "\tLevel " << level_id << " Tags:";
+    std::cout << " Avg: " << total_level_tags / level.size();
+    std::cout << " Min: " << min_level_tags;
+    std::cout << " Max: " << max_level_tags;
+    std::cout << std::endl;
+
+    std::cout << "\tLevel " << level_id << " Permutations:";
+    std::cout << " Total: " << total_permutations;
+    std::cout << " Avg: " << total_permutations / level.size();
+    std::cout << " Min: " << min_permutations;
+    std::cout << " Max: " << max_permutations;
+    std::cout << std::endl;
+}
+
 template<class AnalysisType, class DelayCalcType>
 void SerialTimingAnalyzer<AnalysisType,DelayCalcType>::backward_traversal() {
     using namespace std::chrono;
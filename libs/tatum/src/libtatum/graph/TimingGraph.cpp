@@ -36,6 +36,8 @@ NodeId TimingGraph::add_node(const TN_Type type, const DomainId clock_domain, co
     //Ensure there is space to store the logic function
     if(node_funcs_.size() != (size_t) num_nodes()) {
         node_funcs_.resize(num_nodes());
+        node_truth_tables_.resize(num_nodes(), 0);
+        node_has_truth_tables_.resize(num_nodes(), false);
     }
 
     //Edges
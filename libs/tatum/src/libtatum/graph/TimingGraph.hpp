@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <vector>
 #include <unordered_map>
 #include <map>
@@ -131,6 +132,14 @@ class TimingGraph {
         BDD& node_func(const NodeId id) { return node_funcs_[id]; }
         const BDD& node_func(const NodeId id) const { return node_funcs_[id]; }
 
+        ///\param id The id of a node
+        ///\returns Whether a truth table of the node's logic function is available
+        bool node_has_truth_table(const NodeId id) const { return node_has_truth_tables_[id]; }
+
+        ///\param id The id of a node
+        ///\returns The 64-bit truth table of the node's logic function (only valid if node_has_truth_table())
+        uint64_t node_truth_table(const NodeId id) const { return node_truth_tables_[id]; }
+
         /*
          * Node edge accessors
          */
@@ -239,6 +248,11 @@ class TimingGraph {
         ///\param f The logic function
         void set_node_func(const NodeId node_id, const BDD& f) { node_funcs_[node_id] = f; }
 
+        ///Sets the truth table for a node in the graph
+        ///\param node_id The id of the node to update
+        ///\param tt The truth table of the node's logic function (which must have at most 6 variables)
+        void set_node_truth_table(const NodeId node_id, uint64_t tt) { node_truth_tables_[node_id] = tt; node_has_truth_tables_[node_id] = true; }
+
         /*
          * Graph-level modification operations
          */
@@ -278,6 +292,8 @@ class TimingGraph {
         std::vector<std::vector<EdgeId>> node_in_edges_; //Incomiing edge IDs for node 'node_id' [0..num_nodes()-1][0..num_node_in_edges(node_id)-1]
         std::vector<bool> node_is_clock_source_; //Indicates if a node is the start of clock [0..num_nodes()-1]
         std::vector<BDD> node_funcs_;
+        std::vector<uint64_t> node_truth_tables_; //Truth table of the node function, for small nodes [0..num_nodes()-1]
+        std::vector<bool> node_has_truth_tables_; //Indicates if the node's truth table is valid [0..num_nodes()-1]
 
         //Edge data
         std::vector<NodeId> edge_sink_nodes_; //Sink node for each edge [0..num_edges()-1]
@@ -12,6 +12,7 @@
 using std::cout;
 
 #include "bdd.hpp"
+#include "truth_table.hpp"
 
 BlifTimingGraphBuilder::BlifTimingGraphBuilder(BlifData* data, const sdfparse::DelayFile& sdf_data)
     : blif_data_(data) 
@@ -107,6 +108,8 @@ void BlifTimingGraphBuilder::build(TimingGraph& tg) {
     //check_logical_input_dependancies(tg);
     check_logical_output_dependancies(tg);
 
+    create_truth_tables(tg);
+
     verify(tg);
 }
 
@@ -504,6 +507,25 @@ BDD BlifTimingGraphBuilder::create_func_from_names(const BlifNames* names, const
     return f;
 }
 
+void BlifTimingGraphBuilder::create_truth_tables(TimingGraph& tg) {
+    //Small node functions (e.g. those of K<=6 LUTs) are also stored as truth tables,
+    //so they can be evaluated with bit operations instead of BDD operations.
+    //
+    //The node functions use the input edge indicies as variables, so we require
+    //both the support and the number of inputs to fit in the truth table
+    size_t num_truth_tables = 0;
+    for(NodeId node_id = 0; node_id < tg.num_nodes(); ++node_id) {
+        if(tg.num_node_in_edges(node_id) > (int) TRUTH_TABLE_MAX_VARS) continue;
+
+        TruthTable tt;
+        if(bdd_to_truth_table(tg.node_func(node_id), tt)) {
+            tg.set_node_truth_table(node_id, tt);
+            ++num_truth_tables;
+        }
+    }
+    cout << "Created truth tables for " << num_truth_tables << " of " << tg.num_nodes() << " nodes\n";
+}
+
 void BlifTimingGraphBuilder::verify(const TimingGraph& tg) {
     for(NodeId node_id : tg.primary_inputs()) {
         assert(tg.num_node_in_edges(node_id) == 0);
@@ -31,6 +31,7 @@ class BlifTimingGraphBuilder : public TimingGraphBuilder {
 
         virtual void identify_clock_drivers();
         virtual BDD create_func_from_names(const BlifNames* names, const std::vector<BDD>& input_vars);
+        virtual void create_truth_tables(TimingGraph& tg);
 
 
         virtual void verify(const TimingGraph& tg);
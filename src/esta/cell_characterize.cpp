@@ -35,11 +35,20 @@ std::vector<std::set<std::tuple<TransitionType,TransitionType>>> identify_active
         //Determine all possible input scenarios
         auto all_input_scenarios = cartesian_product(valid_transitions, num_inputs);
 
+        //There are 4^num_inputs scenarios, so evaluate them using the truth table if possible
+        TruthTable tt = 0;
+        bool use_truth_table = (num_inputs <= TRUTH_TABLE_MAX_VARS) && bdd_to_truth_table(f, tt);
+
         //Evaluate all input -> output transitions scenarios,
         // constructing the set of active transitions as we go
         active_input_output_transitions = std::vector<std::set<std::tuple<TransitionType,TransitionType>>>(support_size);
         for(auto input_scenario : all_input_scenarios) {
-            TransitionType computed_output_trans = evaluate_output_transition(input_scenario, f);
+            TransitionType computed_output_trans;
+            if(use_truth_table) {
+                computed_output_trans = evaluate_output_transition(input_scenario, tt);
+            } else {
+                computed_output_trans = evaluate_output_transition(input_scenario, f);
+            }
 
             std::vector<TransitionType> possible_output_transitions;
             if(computed_output_trans == TransitionType::RISE || computed_output_trans == TransitionType::HIGH) {
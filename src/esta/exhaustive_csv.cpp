@@ -0,0 +1,148 @@
+#include <array>
+#include <fstream>
+#include <sstream>
+#include <tuple>
+
+#include "gzstream.h"
+
+#include "exhaustive_csv.hpp"
+#include "TransitionType.hpp"
+
+//The transitions of an input in row order, and the values of its (current, next) variables
+const std::array<std::tuple<TransitionType,bool,bool>,4> INPUT_TRANSITIONS = {{
+    std::make_tuple(TransitionType::RISE, false, true),
+    std::make_tuple(TransitionType::FALL, true, false),
+    std::make_tuple(TransitionType::HIGH, true, true),
+    std::make_tuple(TransitionType::LOW, false, false)
+}};
+
+namespace {
+
+class ExhaustiveCsvWriter {
+    public:
+        ExhaustiveCsvWriter(std::ostream& os, const std::vector<InputTransitionVars>& input_vars, const std::vector<ExhaustiveCsvCase>& cases)
+            : os_(os)
+            , num_rows_(0) {
+            //The cube selecting each transition of each input
+            for(const InputTransitionVars& vars : input_vars) {
+                std::array<BDD,4> cubes;
+                for(size_t i = 0; i < INPUT_TRANSITIONS.size(); ++i) {
+                    BDD curr = std::get<1>(INPUT_TRANSITIONS[i]) ? vars.first : !vars.first;
+                    BDD next = std::get<2>(INPUT_TRANSITIONS[i]) ? vars.second : !vars.second;
+                    cubes[i] = curr & next;
+                }
+                transition_cubes_.push_back(cubes);
+            }
+
+            for(size_t i = 0; i < INPUT_TRANSITIONS.size(); ++i) {
+                std::stringstream ss;
+                ss << std::get<0>(INPUT_TRANSITIONS[i]) << ",";
+                transition_strs_[i] = ss.str();
+            }
+
+            for(const ExhaustiveCsvCase& csv_case : cases) {
+                std::stringstream ss;
+                ss << csv_case.output << "," << csv_case.delay << ",\n";
+                case_suffixes_.push_back(ss.str());
+            }
+        }
+
+        size_t write(const std::vector<ExhaustiveCsvCase>& cases) {
+            std::vector<size_t> case_idxs;
+            std::vector<BDD> funcs;
+            for(size_t i = 0; i < cases.size(); ++i) {
+                if(cases[i].func.IsZero()) continue;
+
+                case_idxs.push_back(i);
+                funcs.push_back(cases[i].func);
+            }
+
+            write_rows_recurr(0, case_idxs, funcs);
+
+            return num_rows_;
+        }
+
+    private:
+        //Writes the rows of the cases (whose functions have been cofactored by the transitions of the
+        //inputs before input_idx, already in row_prefix_)
+        void write_rows_recurr(size_t input_idx, const std::vector<size_t>& case_idxs, const std::vector<BDD>& funcs) {
+            if(case_idxs.empty()) return;
+
+            if(input_idx == transition_cubes_.size()) {
+                //All inputs assigned, so each remaining case holds for this row
+                for(size_t case_idx : case_idxs) {
+                    os_ << row_prefix_ << case_suffixes_[case_idx];
+                    ++num_rows_;
+                }
+                return;
+            }
+
+            if(case_idxs.size() == 1 && funcs[0].IsOne()) {
+                write_all_rows(input_idx, case_idxs[0]);
+                return;
+            }
+
+            size_t prefix_len = row_prefix_.size();
+            for(size_t i = 0; i < INPUT_TRANSITIONS.size(); ++i) {
+                std::vector<size_t> trans_case_idxs;
+                std::vector<BDD> trans_funcs;
+                for(size_t j = 0; j < case_idxs.size(); ++j) {
+                    BDD f = funcs[j].Cofactor(transition_cubes_[input_idx][i]);
+                    if(f.IsZero()) continue;
+
+                    trans_case_idxs.push_back(case_idxs[j]);
+                    trans_funcs.push_back(f);
+                }
+
+                row_prefix_ += transition_strs_[i];
+                write_rows_recurr(input_idx + 1, trans_case_idxs, trans_funcs);
+                row_prefix_.resize(prefix_len);
+            }
+        }
+
+        //Writes the rows of every transition of the inputs from first_input onward for a single case
+        void write_all_rows(size_t first_input, size_t case_idx) {
+            size_t num_inputs = transition_cubes_.size() - first_input;
+            std::vector<size_t> transition_idxs(num_inputs, 0);
+
+            while(true) {
+                os_ << row_prefix_;
+                for(size_t idx : transition_idxs) {
+                    os_ << transition_strs_[idx];
+                }
+                os_ << case_suffixes_[case_idx];
+                ++num_rows_;
+
+                //Advance to the next transition vector (last input least significant)
+                size_t i = num_inputs;
+                while(i > 0 && ++transition_idxs[i - 1] == INPUT_TRANSITIONS.size()) {
+                    transition_idxs[i - 1] = 0;
+                    --i;
+                }
+                if(i == 0) break;
+            }
+        }
+
+    private:
+        std::ostream& os_;
+        std::vector<std::array<BDD,4>> transition_cubes_; //[input][transition]
+        std::array<std::string,4> transition_strs_; //[transition]
+        std::vector<std::string> case_suffixes_; //[case]
+
+        std::string row_prefix_; //The transitions of the inputs assigned so far
+        size_t num_rows_;
+};
+
+} //namespace
+
+size_t write_exhaustive_csv_rows(std::ostream& os, const std::vector<InputTransitionVars>& input_vars, const std::vector<ExhaustiveCsvCase>& cases) {
+    ExhaustiveCsvWriter writer(os, input_vars, cases);
+    return writer.write(cases);
+}
+
+std::unique_ptr<std::ostream> open_csv_file(const std::string& filename, bool compress) {
+    if(compress) {
+        return std::unique_ptr<std::ostream>(new ogzstream(filename.c_str()));
+    }
+    return std::unique_ptr<std::ostream>(new std::ofstream(filename));
+}
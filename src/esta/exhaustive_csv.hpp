@@ -0,0 +1,38 @@
+#pragma once
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bdd.hpp"
+
+//The (current and next state) BDD variables encoding a primary input's transition
+typedef std::pair<BDD,BDD> InputTransitionVars;
+
+//The input transitions (the minterms of func) which produce an output after some delay
+struct ExhaustiveCsvCase {
+    BDD func;
+    std::string output; //Written in the output transition column
+    double delay;
+};
+
+///Writes a row "<input 0 transition>,...,<input n-1 transition>,<output>,<delay>," for each
+///input transition vector satisfying each case's function.
+///
+///Rows are streamed in input vector order (ordered by each input's TransitionType, with the first
+///input most significant) by cofactoring the case functions by each input's transitions in turn.
+///Once a single case covers all transitions of the remaining inputs its rows are enumerated directly.
+///Memory use therefore depends only on the number of inputs and cases, not the number of rows.
+///
+///\param os The stream to write to
+///\param input_vars The variables of each input, in column order
+///\param cases The cases to write
+///\returns The number of rows written
+size_t write_exhaustive_csv_rows(std::ostream& os, const std::vector<InputTransitionVars>& input_vars, const std::vector<ExhaustiveCsvCase>& cases);
+
+///Opens a CSV file for writing
+///\param filename The file to open (conventionally ending in .gz if compressed)
+///\param compress Whether to gzip compress the file
+///\returns The opened stream
+std::unique_ptr<std::ostream> open_csv_file(const std::string& filename, bool compress);
@@ -2,9 +2,11 @@
 #include <fstream>
 #include <string>
 #include <cassert>
+#include <chrono>
 #include <cstdio>
 #include <cmath>
 #include <cstring>
+#include <set>
 
 #include "OptionParser.h"
 
@@ -20,6 +22,7 @@
 #include "BlifTimingGraphBuilder.hpp"
 #include "sta_util.hpp"
 #include "SerialTimingAnalyzer.hpp"
+#include "ParallelEstaTimingAnalyzer.hpp"
 #include "PreCalcDelayCalculator.hpp"
 #include "PreCalcTransDelayCalc.hpp"
 
@@ -35,6 +38,13 @@
 #include "cell_characterize.hpp"
 
 #include "TagReducer.hpp"
+#include "fanin_cone.hpp"
+#include "exhaustive_csv.hpp"
+
+#include "output_workers.hpp"
+#include "MemoryGovernor.hpp"
+#include "ReorderScheduler.hpp"
+#include "checkpoint.hpp"
 
 //Define to print out STA node arrival and required times
 //#define STA_DUMP_ARR_REQ
@@ -54,6 +64,7 @@ using StaAnalyzerType = SerialTimingAnalyzer<StaAnalysisType,DelayCalcType>;
 //ESTA
 using EstaAnalysisType = ExtSetupAnalysisMode<BaseAnalysisMode,ExtTimingTags>;
 using EstaAnalyzerType = SerialTimingAnalyzer<EstaAnalysisType,DelayCalcType>;
+using ParallelEstaAnalyzerType = ParallelEstaTimingAnalyzer<EstaAnalysisType,DelayCalcType>;
 using SharpSatType = SharpSatBddEvaluator<EstaAnalyzerType>;
 
 template class std::vector<ExtTimingTag::cptr>; //Debuging visiblitity
@@ -66,20 +77,22 @@ EtaStats g_eta_stats;
 
 optparse::Values parse_args(int argc, char** argv);
 void print_node_tags(const TimingGraph& tg, std::shared_ptr<EstaAnalyzerType> analyzer, std::shared_ptr<SharpSatType> sharp_sat_eval, NodeId node_id, size_t nvars, float progress);
-void print_node_histogram(const TimingGraph& tg, std::shared_ptr<EstaAnalyzerType> analyzer, std::shared_ptr<SharpSatType> sharp_sat_eval, std::shared_ptr<TimingGraphNameResolver> name_resolver, NodeId node_id, float progress);
+void print_node_histogram(const TimingGraph& tg, std::shared_ptr<EstaAnalyzerType> analyzer, std::shared_ptr<SharpSatType> sharp_sat_eval, std::shared_ptr<TimingGraphNameResolver> name_resolver, NodeId node_id, NodeId orig_node_id, float progress);
+DelayHistogram calc_node_histogram(std::shared_ptr<EstaAnalyzerType> analyzer, std::shared_ptr<SharpSatType> sharp_sat_eval, NodeId node_id);
+void write_node_histogram(const TimingGraph& tg, std::shared_ptr<TimingGraphNameResolver> name_resolver, NodeId node_id, NodeId orig_node_id, const DelayHistogram& delay_prob_histo, float progress);
 void print_max_node_histogram(const TimingGraph& tg, std::shared_ptr<EstaAnalyzerType> analyzer, std::shared_ptr<SharpSatType> sharp_sat_eval, const TagReducer& tag_reducer);
 void dump_exhaustive_csv(std::ostream& os, const TimingGraph& tg, std::shared_ptr<EstaAnalyzerType> analyzer, std::shared_ptr<SharpSatType> sharp_sat_eval, std::shared_ptr<TimingGraphNameResolver> name_resolver, NodeId node_id, size_t nvars);
 void dump_max_exhaustive_csv(std::ostream& os, const TimingGraph& tg, std::shared_ptr<EstaAnalyzerType> analyzer, std::shared_ptr<SharpSatType> sharp_sat_eval, std::shared_ptr<TimingGraphNameResolver> name_resolver, size_t nvars, const TagReducer& tag_reducer);
 std::string print_tag_debug(ExtTimingTag::cptr tag, BDD f, size_t nvars);
 std::vector<std::tuple<ExtTimingTag::cptr,std::shared_ptr<BDD>>> circuit_max_delays(const TimingGraph& tg, std::shared_ptr<EstaAnalyzerType> analyzer, std::shared_ptr<SharpSatType> sharp_sat_eval, const TagReducer& tag_reducer, bool calculate_smallest_max_bdd=true);
-std::vector<std::vector<int>> get_cubes(BDD f, size_t nvars);
-std::vector<std::vector<int>> get_minterms(BDD f, size_t nvars);
-std::vector<std::vector<int>> cube_to_minterms(std::vector<int> cube);
-std::vector<std::vector<TransitionType>> get_transitions(BDD f, size_t nvars);
+std::vector<InputTransitionVars> get_input_transition_vars(size_t nvars);
 
 PreCalcTransDelayCalculator get_pre_calc_trans_delay_calculator(std::map<EdgeId,std::map<TransitionType,Time>>& set_edge_delays, const TimingGraph& tg);
 
 std::vector<std::string> split(const std::string& str, char delim);
+std::vector<NodeId> find_nodes(const TimingGraph& tg, std::shared_ptr<TimingGraphNameResolver> name_resolver, const std::string& node_spec);
+std::string input_node_name(std::shared_ptr<TimingGraphNameResolver> name_resolver, NodeId node_id);
+std::vector<InputVar> resolve_var_order(const TimingGraph& tg, std::shared_ptr<TimingGraphNameResolver> name_resolver, const std::vector<NamedInputVar>& named_var_order);
 
 void write_timing_graph_and_delays_dot(std::ostream& os, const TimingGraph& tg, const PreCalcTransDelayCalculator& delay_calc);
 
@@ -135,6 +148,32 @@ optparse::Values parse_args(int argc, char** argv) {
           .help("The maximum number of permutations to be evaluated at a node in the timing graph during analysis (within slack thresholds). Zero implies no limit.")
           ;
 
+    parser.add_option("-j", "--num_workers")
+          .dest("num_workers")
+          .metavar("NUM_WORKERS")
+          .set_default("1")
+          .help("The number of threads used to evaluate the nodes of each level during ESTA analysis. Default: %default")
+          ;
+
+    parser.add_option("--wide_node_threshold")
+          .dest("wide_node_threshold")
+          .metavar("NUM_PERMUTATIONS")
+          .set_default("100000")
+          .help("Nodes with more input tag permutations than this have their permutations split across all the workers"
+                " (rather than being evaluated by a single worker). Only used with --num_workers > 1. Default: %default")
+          ;
+
+    std::vector<std::string> node_eval_mode_choices = {"PERMUTATION", "CONVOLUTION"};
+    parser.add_option("--node_eval_mode")
+          .dest("node_eval_mode")
+          .choices(node_eval_mode_choices.begin(), node_eval_mode_choices.end())
+          .set_default("PERMUTATION")
+          .metavar("{PERMUTATION | CONVOLUTION}")
+          .help("How input tags are evaluated at each node during ESTA analysis. PERMUTATION evaluates every permutation of input tags (exact),"
+                " CONVOLUTION evaluates each combination of input transitions by max-convolving the input arrival times (approximate, but much faster on high fan-in nodes)."
+                " Default: %default")
+          ;
+
     std::vector<std::string> cond_func_choices = {"UNIFORM", "ROUND_ROBIN", "GROUPED_BINARY", "GROUPED_GRAY"};
     parser.add_option("--condition_function_type")
           .dest("condition_function_type")
@@ -176,6 +215,76 @@ optparse::Values parse_args(int argc, char** argv) {
           .help("The method to use for dynamic BDD variable re-ordering. Default: %default")
           ;
 
+    std::vector<std::string> var_order_choices = {"NETLIST", "DFS"};
+    parser.add_option("--var_order")
+          .dest("var_order")
+          .choices(var_order_choices.begin(), var_order_choices.end())
+          .set_default("DFS")
+          .metavar("{NETLIST | DFS}")
+          .help("The static order of the primary input BDD variables (applied before the condition functions are built)."
+                " NETLIST uses the netlist order, DFS a depth-first traversal of the primary outputs' fanin cones."
+                " Each input's variables are always kept adjacent during dynamic re-ordering. Default: %default")
+          ;
+
+    parser.add_option("--reorder_time_frac")
+          .dest("reorder_time_frac")
+          .metavar("FRAC")
+          .set_default("0.25")
+          .help("The maximum fraction of the run time to spend on dynamic BDD variable re-ordering. "
+                "Re-ordering is postponed while over budget, and backed off, switched to cheaper methods, "
+                "or disabled if it stops shrinking the BDDs. Default: %default")
+          ;
+
+    parser.add_option("--read_var_order")
+          .dest("read_var_order")
+          .metavar("FILE")
+          .help("Start from the primary input variable order saved (by --write_var_order) in a previous run."
+                " Inputs and variables not in the file are placed after those which are, following --var_order.")
+          ;
+
+    parser.add_option("--write_var_order")
+          .dest("write_var_order")
+          .metavar("FILE")
+          .help("Save the final primary input variable order (by input name), for use with --read_var_order.")
+          ;
+
+    parser.add_option("--write_checkpoint")
+          .dest("write_checkpoint")
+          .metavar("FILE")
+          .help("Save the analysis results (node tags and the variable order) after generating the outputs,"
+                " so other outputs can later be generated with --load_checkpoint without re-running the analysis.")
+          ;
+
+    parser.add_option("--checkpoint_xfuncs")
+          .dest("checkpoint_xfuncs")
+          .action("store_true")
+          .set_default("false")
+          .help("Also save the switching functions (BDDs) of the primary outputs' tags in the checkpoint (to FILE.xfuncs.dddmp)."
+                " They are only re-used with the same condition function options. Default: %default")
+          ;
+
+    parser.add_option("--load_checkpoint")
+          .dest("load_checkpoint")
+          .metavar("FILE")
+          .help("Load the analysis results from a checkpoint (written by --write_checkpoint for the same circuit)"
+                " instead of running the ESTA analysis, and generate the requested outputs from them."
+                " If the checkpoint was written part way through the analysis (by --level_checkpoint) the analysis is resumed.")
+          ;
+
+    parser.add_option("--level_checkpoint")
+          .dest("level_checkpoint")
+          .metavar("FILE")
+          .help("Periodically checkpoint the ESTA forward traversal (once a level completes) to FILE,"
+                " so an interrupted analysis can be resumed with --load_checkpoint.")
+          ;
+
+    parser.add_option("--level_checkpoint_interval")
+          .dest("level_checkpoint_interval")
+          .metavar("SECONDS")
+          .set_default("600")
+          .help("The minimum time between checkpoints of the forward traversal. Default: %default")
+          ;
+
     parser.add_option("--max_histogram")
           .set_default(false)
           .action("store_true")
@@ -199,6 +308,13 @@ optparse::Values parse_args(int argc, char** argv) {
           .help("What node delay histograms to print. Must be one of {'po', 'pi', 'all', 'none'} (primary inputs, primary outputs, all nodes). Default: %default")
           ;
 
+    parser.add_option("--output_workers")
+          .dest("output_workers")
+          .metavar("NUM_WORKERS")
+          .set_default("1")
+          .help("The number of worker processes forked to calculate the node delay histograms after analysis. Default: %default")
+          ;
+
     parser.add_option("--print_tags")
           .dest("print_tags")
           .choices(node_choices.begin(), node_choices.end())
@@ -212,6 +328,28 @@ optparse::Values parse_args(int argc, char** argv) {
                 "the specified nodes. Must be 'po', 'all', a comma sepearted list of node names.")
           ;
 
+    parser.add_option("--compress_csv")
+          .action("store_true")
+          .set_default("false")
+          .help("Gzip compress the exhaustive CSV file(s) (named *.csv.gz). Default: %default")
+          ;
+
+    parser.add_option("--restrict_to_fanin_cone")
+          .action("store_true")
+          .set_default("false")
+          .help("Only analyze the transitive fanin cone of the nodes specified by --dump_exhaustive_csv, "
+                "so only the primary inputs in the cone are analyzed and allocated BDD variables. Default: %default")
+          ;
+
+    parser.add_option("--memory_limit")
+          .dest("memory_limit_mib")
+          .metavar("MIB")
+          .set_default("0")
+          .help("The memory budget (in MiB) for the BDD package and analysis caches. "
+                "Cached BDDs are evicted and garbage collected as usage nears the limit. "
+                "Zero implies no limit. Default: %default")
+          ;
+
     parser.add_option("--bdd_stats")
           .dest("show_bdd_stats")
           .action("store_true")
@@ -228,6 +366,13 @@ optparse::Values parse_args(int argc, char** argv) {
         std::exit(1);
     }
 
+    if(options.get_as<bool>("restrict_to_fanin_cone") && !options.is_set("dump_exhaustive_csv")) {
+        cout << "--restrict_to_fanin_cone requires --dump_exhaustive_csv\n";
+        cout << "\n";
+        parser.print_help();
+        std::exit(1);
+    }
+
     return options;
 }
 
@@ -249,11 +394,16 @@ int main(int argc, char** argv) {
     auto options = parse_args(argc, argv);
 
     //Initialize CUDD
-    g_cudd.AutodynEnable(options.get_as<Cudd_ReorderingType>("bdd_reorder_method"));
+    g_reorder_scheduler.configure(g_cudd, options.get_as<Cudd_ReorderingType>("bdd_reorder_method"), options.get_as<double>("reorder_time_frac"));
     //g_cudd.EnableReorderingReporting();
     //Cudd_EnableOrderingMonitoring(g_cudd.getManager());
     g_cudd.AddHook(PreReorderHook, CUDD_PRE_REORDERING_HOOK);
     g_cudd.AddHook(PostReorderHook, CUDD_POST_REORDERING_HOOK);
+    g_cudd.AddHook(ClearMintermFractionMemoHook, CUDD_PRE_REORDERING_HOOK);
+    g_cudd.AddHook(ClearMintermFractionMemoHook, CUDD_PRE_GC_HOOK);
+
+    g_memory_governor.set_limit(options.get_as<size_t>("memory_limit_mib") * 1024 * 1024);
+    g_memory_governor.configure_cudd(g_cudd);
     //g_cudd.AddHook(PreGarbageCollectHook, CUDD_PRE_GC_HOOK);
     //g_cudd.AddHook(PostGarbageCollectHook, CUDD_POST_GC_HOOK);
     //g_cudd.SetSiftMaxSwap(options.get_as<int>("sift_nswaps"));
@@ -261,6 +411,8 @@ int main(int argc, char** argv) {
     //g_cudd.SetMaxGrowth(options.get_as<double>("sift_max_growth"));
     //g_cudd.SetMaxCacheHard(options.get_as<double>("cudd_cache_ratio") * g_cudd.ReadMaxCacheHard());
 
+    g_memory_governor.begin_phase("Build Timing Graph");
+
     g_action_timer.push_timer("Load SDF");
 
     sdfparse::DelayFile sdf_data;
@@ -316,6 +468,42 @@ int main(int argc, char** argv) {
     g_action_timer.pop_timer("Building Timing Graph");
     cout << "\n";
 
+    //The original node id of each timing graph node (only differs if restricted to a fanin cone)
+    std::vector<NodeId> orig_node_ids;
+    for(NodeId id = 0; id < timing_graph.num_nodes(); ++id) {
+        orig_node_ids.push_back(id);
+    }
+
+    if(options.get_as<bool>("restrict_to_fanin_cone")) {
+        g_action_timer.push_timer("Extracting Fanin Cone");
+
+        auto root_nodes = find_nodes(timing_graph, name_resolver, options.get_as<string>("dump_exhaustive_csv"));
+
+        TimingGraph cone_timing_graph;
+        std::vector<EdgeId> orig_edge_ids;
+        extract_fanin_cone(timing_graph, root_nodes, cone_timing_graph, orig_node_ids, orig_edge_ids);
+
+        //Re-map the specified edge delays onto the cone's edges
+        std::map<EdgeId,std::map<TransitionType,Time>> cone_edge_delays;
+        for(EdgeId id = 0; id < cone_timing_graph.num_edges(); ++id) {
+            auto iter = set_edge_delays.find(orig_edge_ids[id]);
+            if(iter != set_edge_delays.end()) {
+                cone_edge_delays[id] = iter->second;
+            }
+        }
+
+        cout << "Fanin Cone of " << root_nodes.size() << " node(s): " << cone_timing_graph.num_nodes() << "/" << timing_graph.num_nodes() << " nodes, ";
+        cout << cone_timing_graph.num_edges() << "/" << timing_graph.num_edges() << " edges, ";
+        cout << cone_timing_graph.logical_inputs().size() << "/" << timing_graph.logical_inputs().size() << " logical inputs\n";
+
+        timing_graph = std::move(cone_timing_graph);
+        set_edge_delays = std::move(cone_edge_delays);
+        name_resolver = std::make_shared<TimingGraphConeNameResolver>(name_resolver, orig_node_ids);
+
+        g_action_timer.pop_timer("Extracting Fanin Cone");
+        cout << "\n";
+    }
+
     if(options.get_as<bool>("print_graph")) {
         cout << "\n";
         cout << "TimingGraph: " << "\n";
@@ -360,6 +548,7 @@ int main(int argc, char** argv) {
     }
     timing_constraints.add_setup_clock_constraint(0, 0, -1.);
 
+    g_memory_governor.begin_phase("STA Analysis");
     g_action_timer.push_timer("STA Analysis");
 
     auto noop_reducer = NoOpTagReducer();
@@ -396,6 +585,7 @@ int main(int argc, char** argv) {
 
     g_action_timer.pop_timer("STA Output");
 
+    g_memory_governor.begin_phase("ESTA Analysis");
     g_action_timer.push_timer("ESTA Analysis");
 
     double slack_threshold_frac = options.get_as<double>("slack_threshold_frac");
@@ -410,18 +600,98 @@ int main(int argc, char** argv) {
     std::cout << "Delay Bin Size Coarse (below threshold) : " << coarse_delay_bin_size << "\n";
     std::cout << "Delay Bin Size Fine (above threshold): " << fine_delay_bin_size << "\n";
     std::cout << "Max Permutations: " << max_permutations << "\n";
+    size_t num_workers = options.get_as<size_t>("num_workers");
+    std::cout << "Analysis Workers: " << num_workers << "\n";
+    size_t wide_node_threshold = options.get_as<size_t>("wide_node_threshold");
+    if(num_workers > 1) {
+        std::cout << "Wide Node Threshold: " << wide_node_threshold << " permutations\n";
+    }
+    std::string node_eval_mode_str = options.get_as<std::string>("node_eval_mode");
+    std::cout << "Node Evaluation Mode: " << node_eval_mode_str << "\n";
     auto tag_reducer = StaSlackTagReducer<StaAnalyzerType>(sta_analyzer, slack_threshold, coarse_delay_bin_size, fine_delay_bin_size);
 
     //The actual analyzer
-    auto esta_analyzer = std::make_shared<EstaAnalyzerType>(timing_graph, timing_constraints, delay_calc, tag_reducer, max_permutations);
+    std::shared_ptr<EstaAnalyzerType> esta_analyzer;
+    if(num_workers > 1) {
+        auto parallel_esta_analyzer = std::make_shared<ParallelEstaAnalyzerType>(timing_graph, timing_constraints, delay_calc, tag_reducer, max_permutations, num_workers);
+        parallel_esta_analyzer->set_wide_node_threshold(wide_node_threshold);
+        esta_analyzer = parallel_esta_analyzer;
+    } else {
+        esta_analyzer = std::make_shared<EstaAnalyzerType>(timing_graph, timing_constraints, delay_calc, tag_reducer, max_permutations);
+    }
+
+
+    esta_analyzer->set_xfunc_cache_node_budget(g_memory_governor.bdd_cache_node_budget());
+    if(node_eval_mode_str == "CONVOLUTION") {
+        esta_analyzer->set_node_eval_mode(NodeEvalMode::CONVOLUTION);
+    } else {
+        assert(node_eval_mode_str == "PERMUTATION");
+        esta_analyzer->set_node_eval_mode(NodeEvalMode::PERMUTATION);
+    }
+    AnalysisCheckpoint checkpoint;
+
+    if(options.is_set("level_checkpoint")) {
+        std::string filename = options.get_as<std::string>("level_checkpoint");
+        double interval = options.get_as<double>("level_checkpoint_interval");
+        auto last_checkpoint = std::chrono::steady_clock::now();
 
+        esta_analyzer->set_level_callback([&, filename, interval, last_checkpoint](LevelId level_id) mutable {
+            auto now = std::chrono::steady_clock::now();
+            if(std::chrono::duration<double>(now - last_checkpoint).count() < interval || level_id + 1 == timing_graph.num_levels()) {
+                return;
+            }
+
+            //Only the nodes of the completed levels have tags so far
+            AnalysisCheckpoint level_checkpoint;
+            level_checkpoint.next_level = level_id + 1;
+            for(NodeId node_id = 0; node_id < timing_graph.num_nodes(); ++node_id) {
+                level_checkpoint.data_tags.push_back(esta_analyzer->setup_data_tags(node_id));
+                level_checkpoint.clock_tags.push_back(esta_analyzer->setup_clock_tags(node_id));
+            }
+            level_checkpoint.cudd_var_order = manager_var_order(g_cudd);
+
+            try {
+                write_checkpoint(filename, timing_graph, level_checkpoint);
+                cout << "\tCheckpointed levels 0-" << level_id << " to " << filename << "\n";
+            } catch(const std::runtime_error& err) {
+                cout << "Warning: " << err.what() << "\n";
+            }
+
+            last_checkpoint = std::chrono::steady_clock::now();
+        });
+    }
+
+    if(options.is_set("load_checkpoint")) {
+        std::string filename = options.get_as<std::string>("load_checkpoint");
+        try {
+            read_checkpoint(filename, timing_graph, checkpoint);
+        } catch(const std::runtime_error& err) {
+            cout << "Error: " << err.what() << "\n";
+            std::exit(1);
+        }
+        esta_analyzer->restore_tags(timing_graph, std::move(checkpoint.data_tags), std::move(checkpoint.clock_tags));
+
+        if(checkpoint.next_level < timing_graph.num_levels()) {
+            //Evaluate the node functions in the same variable order as the interrupted analysis
+            if(!restore_manager_var_order(g_cudd, checkpoint.cudd_var_order)) {
+                cout << "Warning: Checkpoint BDD variable order does not match the node functions, ignoring it\n";
+            }
+
+            cout << "Resuming ESTA analysis at level " << checkpoint.next_level << " with " << g_scenario_store.num_tags() << " tags from checkpoint " << filename << "\n";
+            esta_analyzer->resume_timing(checkpoint.next_level);
+        } else {
+            cout << "Loaded analysis results for " << g_scenario_store.num_tags() << " tags from checkpoint " << filename << "\n";
+        }
+    } else {
+        esta_analyzer->calculate_timing();
+    }
 
-    esta_analyzer->set_xfunc_cache_size(options.get_as<size_t>("xfunc_cache_nelem"));
-    esta_analyzer->calculate_timing();
+    esta_analyzer->set_level_callback(nullptr);
 
     g_action_timer.pop_timer("ESTA Analysis");
 
 
+    g_memory_governor.begin_phase("Output Results");
     g_action_timer.push_timer("Output Results");
 
 
@@ -447,7 +717,80 @@ int main(int argc, char** argv) {
         cond_func_type = ConditionFunctionType::NON_UNIFORM_GROUPED_BY_GRAY_MINTERM;
     }
 
-    auto sharp_sat_eval = std::make_shared<SharpSatType>(timing_graph, cond_func_type, cond_func_seed, nvars_per_input, esta_analyzer);
+    InputVarOrder var_order;
+    if(options.get_as<std::string>("var_order") == "DFS") {
+        var_order = InputVarOrder::DFS;
+    } else {
+        assert(options.get_as<std::string>("var_order") == "NETLIST");
+        var_order = InputVarOrder::NETLIST;
+    }
+
+    //A saved variable order, from --read_var_order or else the loaded checkpoint
+    std::vector<NamedInputVar> named_saved_var_order;
+    std::string saved_var_order_source;
+    if(options.is_set("read_var_order")) {
+        std::string filename = options.get_as<std::string>("read_var_order");
+        std::ifstream is(filename);
+        if(is) {
+            named_saved_var_order = read_var_order(is);
+            saved_var_order_source = filename;
+        } else {
+            cout << "Warning: Could not open variable order file " << filename << ", using the default order\n";
+        }
+    } else if(options.is_set("load_checkpoint") && !checkpoint.var_order.empty()) {
+        //Only checkpoints of complete analyses record the input variable order
+        named_saved_var_order = checkpoint.var_order;
+        saved_var_order_source = options.get_as<std::string>("load_checkpoint");
+    }
+
+    std::vector<InputVar> saved_var_order;
+    if(!saved_var_order_source.empty()) {
+        saved_var_order = resolve_var_order(timing_graph, name_resolver, named_saved_var_order);
+
+        std::set<NodeId> saved_inputs;
+        for(const InputVar& var : saved_var_order) {
+            saved_inputs.insert(var.first);
+        }
+        size_t num_inputs = 0;
+        for(NodeId node_id = 0; node_id < timing_graph.num_nodes(); ++node_id) {
+            if(is_bdd_input_node(timing_graph, node_id)) ++num_inputs;
+        }
+        cout << "Read variable order from " << saved_var_order_source << ": " << saved_inputs.size() << " of " << num_inputs << " inputs found"
+             << " (" << named_saved_var_order.size() - saved_var_order.size() << " saved variables of unknown inputs ignored)\n";
+
+        if(saved_inputs.size() == num_inputs) {
+            //The order is presumably already good, so reorder less eagerly
+            g_reorder_scheduler.back_off();
+        }
+    }
+
+    auto sharp_sat_eval = std::make_shared<SharpSatType>(timing_graph, cond_func_type, cond_func_seed, nvars_per_input, var_order, saved_var_order, esta_analyzer);
+    sharp_sat_eval->set_xfunc_cache_node_budget(g_memory_governor.bdd_cache_node_budget());
+    size_t sharp_sat_pressure_handler = g_memory_governor.add_pressure_handler([&]() {
+        sharp_sat_eval->relieve_memory_pressure();
+    });
+
+    //The xfuncs depend on the condition functions, so are only re-used from a checkpoint with the same ones
+    std::string xfunc_config = cond_func_type_str + " " + std::to_string(cond_func_seed) + " " + std::to_string(nvars_per_input);
+
+    if(options.is_set("load_checkpoint") && !checkpoint.xfunc_tags.empty()) {
+        if(checkpoint.xfunc_config == xfunc_config) {
+            try {
+                read_checkpoint_xfuncs(options.get_as<std::string>("load_checkpoint"), checkpoint);
+
+                std::vector<ExtTimingTag::cptr> xfunc_tags;
+                for(TagId tag_id : checkpoint.xfunc_tags) {
+                    xfunc_tags.push_back(g_scenario_store.tag(tag_id));
+                }
+                sharp_sat_eval->pin_xfuncs(xfunc_tags, checkpoint.xfuncs);
+                cout << "Loaded " << checkpoint.xfuncs.size() << " xfuncs from checkpoint\n";
+            } catch(const std::runtime_error& err) {
+                cout << "Warning: " << err.what() << ", xfuncs will be rebuilt\n";
+            }
+        } else {
+            cout << "Warning: Checkpoint xfuncs were built with different condition functions (" << checkpoint.xfunc_config << "), xfuncs will be rebuilt\n";
+        }
+    }
 
     if(options.get_as<string>("print_tags") != "none") {
         g_action_timer.push_timer("Output tags");
@@ -481,40 +824,82 @@ int main(int argc, char** argv) {
     if(options.get_as<string>("print_histograms") != "none") {
         g_action_timer.push_timer("Output tag histograms");
 
-        float node_count = 0;
+        std::vector<NodeId> histogram_nodes;
         if(options.get_as<string>("print_histograms") == "pi") {
-            for(auto node_id : timing_graph.primary_inputs()) {
-                print_node_histogram(timing_graph, esta_analyzer, sharp_sat_eval, name_resolver, node_id, node_count / timing_graph.primary_inputs().size());
-                node_count += 1;
-            }
+            histogram_nodes = timing_graph.primary_inputs();
         } else if(options.get_as<string>("print_histograms") == "po") {
-            for(auto node_id : timing_graph.primary_outputs()) {
-                print_node_histogram(timing_graph, esta_analyzer, sharp_sat_eval, name_resolver, node_id, node_count / timing_graph.primary_outputs().size());
-                node_count += 1;
-            }
+            histogram_nodes = timing_graph.primary_outputs();
         } else if(options.get_as<string>("print_histograms") == "all") {
             for(LevelId level_id = 0; level_id < timing_graph.num_levels(); level_id++) {
                 for(auto node_id : timing_graph.level(level_id)) {
-                    print_node_histogram(timing_graph, esta_analyzer, sharp_sat_eval, name_resolver, node_id, node_count / timing_graph.num_nodes());
-                    node_count += 1;
+                    histogram_nodes.push_back(node_id);
                 }
             }
         } else {
             assert(0);
         }
+
+        //Plan the xfuncs of all the histogram tags, so the sub-functions shared between nodes
+        //are built once and freed once no longer needed
+        auto plan_histograms = [&](const std::vector<NodeId>& nodes) {
+            std::vector<ExtTimingTag::cptr> tags;
+            for(auto node_id : nodes) {
+                auto& data_tags = esta_analyzer->setup_data_tags(node_id);
+                tags.insert(tags.end(), data_tags.begin(), data_tags.end());
+            }
+            sharp_sat_eval->plan_xfuncs(tags);
+        };
+
+        size_t output_workers = options.get_as<size_t>("output_workers");
+        if(output_workers > 1) {
+            std::cout << "Output Workers: " << output_workers << "\n";
+
+            //Estimate the cost of each node by the number of tags whose xfuncs must be built,
+            //weighted by the node's depth (deeper nodes have larger xfuncs)
+            std::vector<double> node_costs;
+            for(auto node_id : histogram_nodes) {
+                node_costs.push_back(esta_analyzer->setup_data_tags(node_id).num_tags() * (timing_graph.node_level(node_id) + 1.));
+            }
+
+            float node_count = 0;
+            auto calc_histogram = [&](NodeId node_id) {
+                return calc_node_histogram(esta_analyzer, sharp_sat_eval, node_id);
+            };
+            auto write_histogram = [&](NodeId node_id, const DelayHistogram& delay_prob_histo) {
+                write_node_histogram(timing_graph, name_resolver, node_id, orig_node_ids[node_id], delay_prob_histo, node_count / histogram_nodes.size());
+                node_count += 1;
+            };
+
+            if(!fork_node_histograms(histogram_nodes, node_costs, output_workers, plan_histograms, calc_histogram, write_histogram)) {
+                cerr << "Failed to calculate node histograms\n";
+                return 1;
+            }
+        } else {
+            plan_histograms(histogram_nodes);
+
+            float node_count = 0;
+            for(auto node_id : histogram_nodes) {
+                print_node_histogram(timing_graph, esta_analyzer, sharp_sat_eval, name_resolver, node_id, orig_node_ids[node_id], node_count / histogram_nodes.size());
+                node_count += 1;
+            }
+        }
+        //The plan only covers the histograms, later outputs build (and cache) their xfuncs as usual
+        sharp_sat_eval->end_plan();
         g_action_timer.pop_timer("Output tag histograms"); 
     }
 
     bool do_max_exhaustive = options.get_as<bool>("max_exhaustive");
+    bool compress_csv = options.get_as<bool>("compress_csv");
 
     if(do_max_exhaustive) {
         g_action_timer.push_timer("Exhaustive Max CSV");
         std::string csv_filename = "esta.max_trans.csv";
-        std::ofstream csv_os(csv_filename);
+        if(compress_csv) csv_filename += ".gz";
+        auto csv_os = open_csv_file(csv_filename, compress_csv);
 
         std::cout << "Writing " << csv_filename << " for circuit max delay\n";
 
-        dump_max_exhaustive_csv(csv_os, timing_graph, esta_analyzer, sharp_sat_eval, name_resolver, nvars, tag_reducer);
+        dump_max_exhaustive_csv(*csv_os, timing_graph, esta_analyzer, sharp_sat_eval, name_resolver, nvars, tag_reducer);
         g_action_timer.pop_timer("Exhaustive Max CSV");
     }
 
@@ -522,39 +907,19 @@ int main(int argc, char** argv) {
         g_action_timer.push_timer("Exhaustive CSV");
 
 
-        std::string node_spec = options.get_as<string>("dump_exhaustive_csv");
-        std::vector<NodeId> nodes_to_dump;
-        if(node_spec == "po") {
-            for(NodeId id : timing_graph.primary_outputs()) {
-                nodes_to_dump.push_back(id);
-            }
-        } else if(node_spec == "all") {
-            for(NodeId id = 0; id < timing_graph.num_nodes(); ++id) {
-                nodes_to_dump.push_back(id);
-            }
-        } else {
-            auto names = split(node_spec, ',');
-
-            //Naieve
-            for(NodeId id = 0; id < timing_graph.num_nodes(); ++id) {
-                for(auto name : names) {
-                    if(name == name_resolver->get_node_name(id)) {
-                        nodes_to_dump.push_back(id);
-                    }
-                }
-            }
-        }
+        auto nodes_to_dump = find_nodes(timing_graph, name_resolver, options.get_as<string>("dump_exhaustive_csv"));
 
         for(NodeId node_id : nodes_to_dump) {
             std::string node_name = name_resolver->get_node_name(node_id);
 
 
-            std::string csv_filename = "esta.trans." + node_name + ".n" + std::to_string(node_id) + ".csv";
-            std::ofstream csv_os(csv_filename);
+            std::string csv_filename = "esta.trans." + node_name + ".n" + std::to_string(orig_node_ids[node_id]) + ".csv";
+            if(compress_csv) csv_filename += ".gz";
+            auto csv_os = open_csv_file(csv_filename, compress_csv);
 
             std::cout << "Writing " << csv_filename << " for node " << node_id << "\n";
 
-            dump_exhaustive_csv(csv_os, timing_graph, esta_analyzer, sharp_sat_eval, name_resolver, node_id, nvars);
+            dump_exhaustive_csv(*csv_os, timing_graph, esta_analyzer, sharp_sat_eval, name_resolver, node_id, nvars);
         }
 
         g_action_timer.pop_timer("Exhaustive CSV");
@@ -567,7 +932,55 @@ int main(int argc, char** argv) {
 
 
 
+    std::vector<NamedInputVar> named_var_order;
+    for(const InputVar& var : sharp_sat_eval->input_var_order()) {
+        named_var_order.emplace_back(input_node_name(name_resolver, var.first), var.second);
+    }
+
+    if(options.is_set("write_var_order")) {
+        std::ofstream os(options.get_as<std::string>("write_var_order"));
+        write_var_order(os, named_var_order);
+    }
+
+    if(options.is_set("write_checkpoint")) {
+        g_action_timer.push_timer("Write Checkpoint");
+
+        checkpoint.data_tags.clear();
+        checkpoint.clock_tags.clear();
+        for(NodeId node_id = 0; node_id < timing_graph.num_nodes(); ++node_id) {
+            checkpoint.data_tags.push_back(esta_analyzer->setup_data_tags(node_id));
+            checkpoint.clock_tags.push_back(esta_analyzer->setup_clock_tags(node_id));
+        }
+        checkpoint.next_level = timing_graph.num_levels();
+        checkpoint.cudd_var_order = manager_var_order(g_cudd);
+        checkpoint.var_order = named_var_order;
+
+        checkpoint.xfunc_config = xfunc_config;
+        checkpoint.xfunc_tags.clear();
+        checkpoint.xfuncs.clear();
+        if(options.get_as<bool>("checkpoint_xfuncs")) {
+            for(NodeId node_id : timing_graph.primary_outputs()) {
+                for(ExtTimingTag::cptr tag : esta_analyzer->setup_data_tags(node_id)) {
+                    checkpoint.xfunc_tags.push_back(tag->id());
+                    checkpoint.xfuncs.push_back(sharp_sat_eval->build_bdd_xfunc(tag));
+                }
+            }
+            sharp_sat_eval->reset();
+        }
+
+        try {
+            write_checkpoint(options.get_as<std::string>("write_checkpoint"), timing_graph, checkpoint);
+        } catch(const std::runtime_error& err) {
+            cout << "Error: " << err.what() << "\n";
+        }
+
+        g_action_timer.pop_timer("Write Checkpoint");
+    }
+
+    g_memory_governor.remove_pressure_handler(sharp_sat_pressure_handler);
+
     g_action_timer.pop_timer("Output Results");
+    g_memory_governor.end_phase();
 
     cout << "\n";
     cout << "BDD Stats after analysis:\n";
@@ -580,6 +993,12 @@ int main(int argc, char** argv) {
     cout << "\treorder time (s): " << reorder_time_sec << " (" << reorder_time_sec / g_action_timer.elapsed("ETA Application") << " total)\n";
     cout << "\n";
 
+    g_reorder_scheduler.print_report(cout);
+    cout << "\n";
+
+    g_memory_governor.print_report(cout);
+    cout << "\n";
+
     if(options.get_as<bool>("show_bdd_stats")) {
         cout << endl;
         g_cudd.info();
@@ -624,21 +1043,17 @@ void print_node_tags(const TimingGraph& tg, std::shared_ptr<EstaAnalyzerType> an
     }
 }
 
-void print_node_histogram(const TimingGraph& tg, std::shared_ptr<EstaAnalyzerType> analyzer, std::shared_ptr<SharpSatType> sharp_sat_eval, std::shared_ptr<TimingGraphNameResolver> name_resolver, NodeId node_id, float progress) {
+void print_node_histogram(const TimingGraph& tg, std::shared_ptr<EstaAnalyzerType> analyzer, std::shared_ptr<SharpSatType> sharp_sat_eval, std::shared_ptr<TimingGraphNameResolver> name_resolver, NodeId node_id, NodeId orig_node_id, float progress) {
     g_action_timer.push_timer("Node " + std::to_string(node_id) + " histogram"); 
 
-    std::string node_name;
-    if(tg.node_type(node_id) == TN_Type::OUTPAD_SINK) {
-        auto edge_id = tg.node_in_edge(node_id, 0);
-        auto ipin_node_id = tg.edge_src_node(edge_id);
-        node_name = name_resolver->get_node_name(ipin_node_id);
-    } else {
-        node_name = name_resolver->get_node_name(node_id);
-    }
+    auto delay_prob_histo = calc_node_histogram(analyzer, sharp_sat_eval, node_id);
 
+    write_node_histogram(tg, name_resolver, node_id, orig_node_id, delay_prob_histo, progress);
 
-    cout << "Node: " << node_id << " (" << node_name << ") " << tg.node_type(node_id) << " (" << progress*100 << "%)\n";
+    g_action_timer.pop_timer("Node " + std::to_string(node_id) + " histogram"); 
+}
 
+DelayHistogram calc_node_histogram(std::shared_ptr<EstaAnalyzerType> analyzer, std::shared_ptr<SharpSatType> sharp_sat_eval, NodeId node_id) {
     auto& raw_data_tags = analyzer->setup_data_tags(node_id);
 
     //Sort the tags so they come out in order
@@ -648,15 +1063,35 @@ void print_node_histogram(const TimingGraph& tg, std::shared_ptr<EstaAnalyzerTyp
     };
     std::sort(sorted_data_tags.begin(), sorted_data_tags.end(), tag_sorter);
 
-    std::map<double,double> delay_prob_histo;
-    for(auto tag : sorted_data_tags) {
+    auto switch_probs = sharp_sat_eval->count_sat_fractions(sorted_data_tags);
+
+    DelayHistogram delay_prob_histo;
+    for(size_t i = 0; i < sorted_data_tags.size(); ++i) {
 
-        auto delay = tag->arr_time().value();
-        auto switch_prob = sharp_sat_eval->count_sat_fraction(tag);
+        auto delay = sorted_data_tags[i]->arr_time().value();
+        auto switch_prob = switch_probs[i];
 
         delay_prob_histo[delay] += switch_prob;
     }
 
+    sharp_sat_eval->reset();
+
+    return delay_prob_histo;
+}
+
+void write_node_histogram(const TimingGraph& tg, std::shared_ptr<TimingGraphNameResolver> name_resolver, NodeId node_id, NodeId orig_node_id, const DelayHistogram& delay_prob_histo, float progress) {
+    std::string node_name;
+    if(tg.node_type(node_id) == TN_Type::OUTPAD_SINK) {
+        auto edge_id = tg.node_in_edge(node_id, 0);
+        auto ipin_node_id = tg.edge_src_node(edge_id);
+        node_name = name_resolver->get_node_name(ipin_node_id);
+    } else {
+        node_name = name_resolver->get_node_name(node_id);
+    }
+
+
+    cout << "Node: " << node_id << " (" << node_name << ") " << tg.node_type(node_id) << " (" << progress*100 << "%)\n";
+
     double total_prob = 0.;
 
     //Print to stdou
@@ -677,7 +1112,7 @@ void print_node_histogram(const TimingGraph& tg, std::shared_ptr<EstaAnalyzerTyp
     assert(total_prob >= 1. - epsilon && total_prob <= 1. + epsilon);
 
     //Print to a csv
-    std::string filename = "esta.hist." + node_name + ".n" + std::to_string(node_id) + ".csv";
+    std::string filename = "esta.hist." + node_name + ".n" + std::to_string(orig_node_id) + ".csv";
     std::ofstream os(filename);
 
     //Header
@@ -689,13 +1124,7 @@ void print_node_histogram(const TimingGraph& tg, std::shared_ptr<EstaAnalyzerTyp
         auto switch_prob = kv.second;
 
         os << delay << "," << switch_prob << "\n"; 
-
-        total_prob += switch_prob;
     }
-
-    sharp_sat_eval->reset();
-
-    g_action_timer.pop_timer("Node " + std::to_string(node_id) + " histogram"); 
 }
 
 void print_max_node_histogram(const TimingGraph& tg, std::shared_ptr<EstaAnalyzerType> analyzer, std::shared_ptr<SharpSatType> sharp_sat_eval, const TagReducer& tag_reducer) {
@@ -779,33 +1208,14 @@ void print_max_node_histogram(const TimingGraph& tg, std::shared_ptr<EstaAnalyze
 void dump_exhaustive_csv(std::ostream& os, const TimingGraph& tg, std::shared_ptr<EstaAnalyzerType> analyzer, std::shared_ptr<SharpSatType> sharp_sat_eval, std::shared_ptr<TimingGraphNameResolver> name_resolver, NodeId node_id, size_t nvars) {
     auto& data_tags = analyzer->setup_data_tags(node_id);
 
-    using TupleVal = std::tuple<std::vector<TransitionType>,TransitionType,double>;
-    std::vector<TupleVal> exhaustive_values;
-
+    std::vector<ExhaustiveCsvCase> exhaustive_cases;
     for(auto tag : data_tags) {
-        auto bdd = sharp_sat_eval->build_bdd_xfunc(tag, node_id);
-
-        auto input_transitions = get_transitions(bdd, nvars);
-
-        for(auto input_case : input_transitions) {
-            assert(input_case.size() == nvars / 2);
-            auto tuple = std::make_tuple(input_case, tag->trans_type(), tag->arr_time().value());
-            exhaustive_values.push_back(tuple);
-        }
-    }
-
-    //Covered all exhaustive cases
-    assert(exhaustive_values.size() == pow(2, nvars));
+        std::stringstream ss;
+        ss << tag->trans_type();
 
-    //Radix-style sort on input transitions
-    for(int i = (nvars / 2) - 1; i >= 0; --i) {
-        auto sort_order = [&](const TupleVal& lhs, const TupleVal& rhs) {
-            return std::get<0>(lhs)[i] < std::get<0>(rhs)[i]; 
-        };
-        std::stable_sort(exhaustive_values.begin(), exhaustive_values.end(), sort_order);
+        exhaustive_cases.push_back({sharp_sat_eval->build_bdd_xfunc(tag, node_id), ss.str(), tag->arr_time().value()});
     }
 
-    
     //CSV Header
     for(int i = g_cudd.ReadSize() - nvars; i < g_cudd.ReadSize(); i += 2) {
         auto var_name = g_cudd.getVariableName(i);
@@ -822,19 +1232,12 @@ void dump_exhaustive_csv(std::ostream& os, const TimingGraph& tg, std::shared_pt
     os << "delay" << ",";
     os << "\n";
 
-    //CSV Values
-    for(auto tuple : exhaustive_values) {
-        //Input transitions
-        for(auto trans : std::get<0>(tuple)) {
-            os << trans << ",";
-        }
-        //Output transition
-        os << std::get<1>(tuple) << ",";
-        //Delay
-        os << std::get<2>(tuple) << ",";
-        
-        os << "\n";
-    }
+    //CSV Values (streamed in input transition order)
+    size_t num_rows = write_exhaustive_csv_rows(os, get_input_transition_vars(nvars), exhaustive_cases);
+
+    //Covered all exhaustive cases
+    assert(num_rows == pow(2, nvars));
+    (void) num_rows;
 }
 
 std::string print_tag_debug(ExtTimingTag::cptr tag, BDD f, size_t nvars) {
@@ -901,11 +1304,10 @@ std::vector<std::tuple<ExtTimingTag::cptr,std::shared_ptr<BDD>>> circuit_max_del
     //with delay lower than the maximum.
 
     //Sort into descending order
-    std::sort(max_tags.begin(), max_tags.end(),
-                [](ExtTimingTag::cptr lhs, ExtTimingTag::cptr rhs) {
-                    return lhs->arr_time().value() > rhs->arr_time().value();
-                }
-             );
+    max_tags.sort([](ExtTimingTag::cptr lhs, ExtTimingTag::cptr rhs) {
+                      return lhs->arr_time().value() > rhs->arr_time().value();
+                  }
+                 );
 
     std::vector<std::tuple<ExtTimingTag::cptr,std::shared_ptr<BDD>>> max_delays;
 
@@ -953,29 +1355,22 @@ std::vector<std::tuple<ExtTimingTag::cptr,std::shared_ptr<BDD>>> circuit_max_del
 }
 
 void dump_max_exhaustive_csv(std::ostream& os, const TimingGraph& tg, std::shared_ptr<EstaAnalyzerType> analyzer, std::shared_ptr<SharpSatType> sharp_sat_eval, std::shared_ptr<TimingGraphNameResolver> name_resolver, size_t nvars, const TagReducer& tag_reducer) {
-    ExtTimingTags max_tags;
-
-
-    //Evaluate and them
-    using TupleVal = std::tuple<std::vector<TransitionType>,TransitionType,double>;
-    std::vector<TupleVal> exhaustive_values;
+    //Evaluate the max delay tags
+    std::vector<ExhaustiveCsvCase> exhaustive_cases;
 
     auto max_delays = circuit_max_delays(tg, analyzer, sharp_sat_eval, tag_reducer, false);
+    BDD covered_terms = g_cudd.bddZero();
     for(auto tag_bdd_tuple : max_delays) {
         auto tag = std::get<0>(tag_bdd_tuple);
-        auto bdd = *(std::get<1>(tag_bdd_tuple));
 
-        auto input_transitions = get_transitions(bdd, nvars);
+        //The last (smallest delay) tag's BDD is not calculated, it covers all remaining cases
+        auto bdd_ptr = std::get<1>(tag_bdd_tuple);
+        BDD bdd = (bdd_ptr) ? *bdd_ptr : !covered_terms;
+        covered_terms |= bdd;
 
-        for(auto input_case : input_transitions) {
-            assert(input_case.size() == nvars / 2);
-            auto tuple = std::make_tuple(input_case, TransitionType::MAX, tag->arr_time().value());
-            exhaustive_values.push_back(tuple);
-        }
+        exhaustive_cases.push_back({bdd, "-", tag->arr_time().value()});
     }
 
-    assert(exhaustive_values.size() == pow(2, nvars));
-
     //CSV Header
     for(int i = g_cudd.ReadSize() - nvars; i < g_cudd.ReadSize(); i += 2) {
         auto var_name = g_cudd.getVariableName(i);
@@ -992,122 +1387,21 @@ void dump_max_exhaustive_csv(std::ostream& os, const TimingGraph& tg, std::share
     os << "delay" << ",";
     os << "\n";
 
-    //CSV Values
-    for(auto tuple : exhaustive_values) {
-        //Input transitions
-        for(auto trans : std::get<0>(tuple)) {
-            os << trans << ",";
-        }
-        //Output transition
-        //os << std::get<1>(tuple) << ",";
-        os << "-" << ",";
-        //Delay
-        os << std::get<2>(tuple) << ",";
-        
-        os << "\n";
-    }
-}
-
-std::vector<std::vector<TransitionType>> get_transitions(BDD f, size_t nvars) {
-    std::vector<std::vector<TransitionType>> transitions;
-    auto minterms = get_minterms(f, nvars);
-
-    for(auto minterm : minterms) {
-        std::vector<TransitionType> input_transitions;
-
-        //Expect pairs of variables
-        assert(minterm.size() % 2 == 0);
-        assert(minterm.size() == nvars);
-
-        for(size_t i = 0; i < minterm.size() - 1; i += 2) {
-            //Walk through pairs of variables
-            auto prev = minterm[i];
-            auto next = minterm[i+1];
-
-            TransitionType trans;
-            if(prev == 0 && next == 1) trans = TransitionType::RISE;
-            else if(prev == 1 && next == 0) trans = TransitionType::FALL;
-            else if(prev == 1 && next == 1) trans = TransitionType::HIGH;
-            else if(prev == 0 && next == 0) trans = TransitionType::LOW;
-            else assert(false);
-
-            input_transitions.push_back(trans);
-        }
-
-
-        transitions.push_back(input_transitions);
-    }
-
-    return transitions;
-}
-
-std::vector<std::vector<int>> get_minterms(BDD f, size_t nvars) {
-    //Determine the starting index of the transition vars
-    //(rather than those used to store logic functions)
-
-    //Get the cubes (which include don't cares)
-    //for the function f
-    auto cubes = get_cubes(f, nvars);
-
-    //We want minterms, so we need to expand the cubes into minterms
-    //(i.e. without don't cares)
-    std::vector<std::vector<int>> minterms;
-    for(auto cube : cubes) {
-
-        int num_dc = 0;
-        for(auto val : cube) {
-            if(val == 2) num_dc++;
-        }
-
-        auto expanded_minterms = cube_to_minterms(cube); 
-
-        auto expected_num_minterms = pow(2, num_dc);
+    //CSV Values (streamed in input transition order)
+    size_t num_rows = write_exhaustive_csv_rows(os, get_input_transition_vars(nvars), exhaustive_cases);
 
-        assert(expanded_minterms.size() == expected_num_minterms);
-        
-        std::copy(expanded_minterms.begin(), expanded_minterms.end(), std::back_inserter(minterms));
-    }
-
-    return minterms;
-}
-
-std::vector<std::vector<int>> cube_to_minterms(std::vector<int> cube) {
-    std::vector<std::vector<int>> minterms;
-
-    auto iter = std::find(cube.begin(), cube.end(), 2); //CUDD returns DC's as integer value 2
-    if(iter == cube.end()) {
-        minterms.push_back(cube);
-        return minterms;
-    } else {
-        //Call with DC set to 0
-        *iter = 0;
-        auto minterms_0 = cube_to_minterms(cube); 
-        auto back_insert_iter = std::copy(minterms_0.begin(), minterms_0.end(), std::back_inserter(minterms));
-
-        //Call with DC set to 1
-        *iter = 1;
-        auto minterms_1 = cube_to_minterms(cube);
-        std::copy(minterms_1.begin(), minterms_1.end(), back_insert_iter);
-    }
-
-    return minterms;
+    assert(num_rows == pow(2, nvars));
+    (void) num_rows;
 }
 
-std::vector<std::vector<int>> get_cubes(BDD f, size_t nvars) {
-    std::vector<std::vector<int>> cubes;
-
-    int* cube_data;
-    CUDD_VALUE_TYPE val;
-    DdGen* gen;
-    Cudd_ForeachCube(f.manager(), f.getNode(), gen, cube_data, val) {
-        assert(val == 1); //Always holds for BDDs
-
-        std::vector<int> cube;
-        std::copy(cube_data + g_cudd.ReadSize() - nvars, cube_data + g_cudd.ReadSize(), std::back_inserter(cube));
-        cubes.push_back(cube);
+std::vector<InputTransitionVars> get_input_transition_vars(size_t nvars) {
+    //The transition vars are the last nvars variables (after those used to store logic functions),
+    //with a (current, next) pair per input
+    std::vector<InputTransitionVars> input_vars;
+    for(int i = g_cudd.ReadSize() - nvars; i < g_cudd.ReadSize(); i += 2) {
+        input_vars.emplace_back(g_cudd.bddVar(i), g_cudd.bddVar(i+1));
     }
-
-    return cubes;
+    return input_vars;
 }
 
 PreCalcTransDelayCalculator get_pre_calc_trans_delay_calculator(std::map<EdgeId,std::map<TransitionType,Time>>& set_edge_delays, const TimingGraph& tg) {
@@ -1141,6 +1435,59 @@ std::vector<std::string> split(const std::string& str, char delim) {
     return elements;
 }
 
+std::vector<NodeId> find_nodes(const TimingGraph& tg, std::shared_ptr<TimingGraphNameResolver> name_resolver, const std::string& node_spec) {
+    std::vector<NodeId> nodes;
+    if(node_spec == "po") {
+        for(NodeId id : tg.primary_outputs()) {
+            nodes.push_back(id);
+        }
+    } else if(node_spec == "all") {
+        for(NodeId id = 0; id < tg.num_nodes(); ++id) {
+            nodes.push_back(id);
+        }
+    } else {
+        auto names = split(node_spec, ',');
+
+        //Naieve
+        for(NodeId id = 0; id < tg.num_nodes(); ++id) {
+            for(auto name : names) {
+                if(name == name_resolver->get_node_name(id)) {
+                    nodes.push_back(id);
+                }
+            }
+        }
+    }
+    return nodes;
+}
+
+std::string input_node_name(std::shared_ptr<TimingGraphNameResolver> name_resolver, NodeId node_id) {
+    //We use node_id+1 since we name the input pin, rather than the source (as in the CSV headers)
+    return name_resolver->get_node_name(node_id + 1);
+}
+
+std::vector<InputVar> resolve_var_order(const TimingGraph& tg, std::shared_ptr<TimingGraphNameResolver> name_resolver, const std::vector<NamedInputVar>& named_var_order) {
+    //Names shared by multiple inputs (e.g. unnamed ones) can not be resolved
+    std::map<std::string,NodeId> inputs_by_name;
+    std::set<std::string> ambiguous_names;
+    for(NodeId node_id = 0; node_id < tg.num_nodes(); ++node_id) {
+        if(!is_bdd_input_node(tg, node_id)) continue;
+
+        std::string name = input_node_name(name_resolver, node_id);
+        if(!inputs_by_name.insert(std::make_pair(name, node_id)).second) {
+            ambiguous_names.insert(name);
+        }
+    }
+
+    std::vector<InputVar> var_order;
+    for(const NamedInputVar& named_var : named_var_order) {
+        auto iter = inputs_by_name.find(named_var.first);
+        if(iter == inputs_by_name.end() || ambiguous_names.count(named_var.first)) continue;
+
+        var_order.emplace_back(iter->second, named_var.second);
+    }
+    return var_order;
+}
+
 void write_timing_graph_and_delays_dot(std::ostream& os, const TimingGraph& tg, const PreCalcTransDelayCalculator& delay_calc) {
     //Write out a dot file of the timing graph
     os << "digraph G {" <<std::endl;
@@ -0,0 +1,234 @@
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <queue>
+
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "output_workers.hpp"
+#include "MemoryGovernor.hpp"
+
+/*
+ * Each histogram is sent from a worker as a message of:
+ *
+ *   [uint32_t node_id][uint32_t num_bins][num_bins x (double delay, double probability)]
+ */
+namespace {
+
+const size_t MSG_HEADER_SIZE = 2*sizeof(uint32_t);
+const size_t MSG_BIN_SIZE = 2*sizeof(double);
+
+bool write_all(int fd, const char* data, size_t size) {
+    while(size > 0) {
+        ssize_t written = write(fd, data, size);
+        if(written < 0) {
+            if(errno == EINTR) continue;
+            return false;
+        }
+        data += written;
+        size -= written;
+    }
+    return true;
+}
+
+void append_bytes(std::vector<char>& buf, const void* data, size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    buf.insert(buf.end(), bytes, bytes + size);
+}
+
+bool send_histogram(int fd, NodeId node_id, const DelayHistogram& histogram) {
+    std::vector<char> msg;
+    uint32_t header[2] = {node_id, static_cast<uint32_t>(histogram.size())};
+    append_bytes(msg, header, sizeof(header));
+    for(auto kv : histogram) {
+        double bin[2] = {kv.first, kv.second};
+        append_bytes(msg, bin, sizeof(bin));
+    }
+    return write_all(fd, msg.data(), msg.size());
+}
+
+//Consumes any complete messages at the start of buf, calling write_histogram for each
+void receive_histograms(std::vector<char>& buf, std::function<void(NodeId,const DelayHistogram&)> write_histogram) {
+    size_t offset = 0;
+    while(buf.size() - offset >= MSG_HEADER_SIZE) {
+        uint32_t header[2];
+        std::memcpy(header, buf.data() + offset, sizeof(header));
+
+        size_t msg_size = MSG_HEADER_SIZE + header[1]*MSG_BIN_SIZE;
+        if(buf.size() - offset < msg_size) break; //Incomplete
+
+        DelayHistogram histogram;
+        const char* bins = buf.data() + offset + MSG_HEADER_SIZE;
+        for(size_t i = 0; i < header[1]; ++i) {
+            double bin[2];
+            std::memcpy(bin, bins + i*MSG_BIN_SIZE, sizeof(bin));
+            histogram[bin[0]] = bin[1];
+        }
+        write_histogram(header[0], histogram);
+
+        offset += msg_size;
+    }
+    buf.erase(buf.begin(), buf.begin() + offset);
+}
+
+} //namespace
+
+std::vector<std::vector<NodeId>> partition_nodes_by_cost(const std::vector<NodeId>& nodes, const std::vector<double>& node_costs, size_t num_workers) {
+    assert(nodes.size() == node_costs.size());
+    assert(num_workers > 0);
+
+    //Most expensive first
+    std::vector<size_t> order(nodes.size());
+    for(size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+        return node_costs[lhs] > node_costs[rhs];
+    });
+
+    //Least loaded worker on top
+    typedef std::pair<double,size_t> Load;
+    std::priority_queue<Load,std::vector<Load>,std::greater<Load>> loads;
+    for(size_t i = 0; i < num_workers; ++i) {
+        loads.push(Load(0., i));
+    }
+
+    std::vector<size_t> node_workers(nodes.size());
+    for(size_t idx : order) {
+        Load load = loads.top();
+        loads.pop();
+
+        node_workers[idx] = load.second;
+        load.first += node_costs[idx];
+        loads.push(load);
+    }
+
+    std::vector<std::vector<NodeId>> partitions(num_workers);
+    for(size_t i = 0; i < nodes.size(); ++i) {
+        partitions[node_workers[i]].push_back(nodes[i]);
+    }
+    return partitions;
+}
+
+bool fork_node_histograms(const std::vector<NodeId>& nodes, const std::vector<double>& node_costs, size_t num_workers,
+                          std::function<void(const std::vector<NodeId>&)> init_worker,
+                          std::function<DelayHistogram(NodeId)> calc_histogram,
+                          std::function<void(NodeId,const DelayHistogram&)> write_histogram) {
+    auto partitions = partition_nodes_by_cost(nodes, node_costs, num_workers);
+    size_t num_forked = std::count_if(partitions.begin(), partitions.end(), [](const std::vector<NodeId>& worker_nodes) {
+        return !worker_nodes.empty();
+    });
+
+    //Flush any buffered output so it is not duplicated by the workers
+    std::cout.flush();
+    std::cerr.flush();
+
+    bool success = true;
+    std::vector<pid_t> pids;
+    std::vector<int> fds;
+    for(const auto& worker_nodes : partitions) {
+        if(worker_nodes.empty()) continue;
+
+        int pipe_fds[2];
+        if(pipe(pipe_fds) != 0) {
+            std::cerr << "Failed to create pipe for output worker: " << std::strerror(errno) << "\n";
+            success = false;
+            break;
+        }
+
+        pid_t pid = fork();
+        if(pid < 0) {
+            std::cerr << "Failed to fork output worker: " << std::strerror(errno) << "\n";
+            close(pipe_fds[0]);
+            close(pipe_fds[1]);
+            success = false;
+            break;
+        }
+
+        if(pid == 0) {
+            //Worker
+            close(pipe_fds[0]);
+            for(int fd : fds) {
+                close(fd); //Other workers' pipes
+            }
+
+            //The workers run concurrently, so each gets a share of the memory budget
+            g_memory_governor.split_limit(num_forked);
+
+            init_worker(worker_nodes);
+
+            int status = 0;
+            for(NodeId node_id : worker_nodes) {
+                if(!send_histogram(pipe_fds[1], node_id, calc_histogram(node_id))) {
+                    status = 1;
+                    break;
+                }
+            }
+            close(pipe_fds[1]);
+            std::cout.flush();
+
+            //Skip any exit handlers/destructors, which belong to the parent
+            _exit(status);
+        }
+
+        //Parent
+        close(pipe_fds[1]);
+        pids.push_back(pid);
+        fds.push_back(pipe_fds[0]);
+    }
+
+    //Stream the results back as they become available
+    std::vector<std::vector<char>> bufs(fds.size());
+    std::vector<pollfd> poll_fds;
+    for(int fd : fds) {
+        poll_fds.push_back({fd, POLLIN, 0});
+    }
+
+    size_t num_open = fds.size();
+    while(num_open > 0) {
+        if(poll(poll_fds.data(), poll_fds.size(), -1) < 0) {
+            if(errno == EINTR) continue;
+            std::cerr << "Failed to poll output workers: " << std::strerror(errno) << "\n";
+            success = false;
+            break;
+        }
+
+        for(size_t i = 0; i < poll_fds.size(); ++i) {
+            if(poll_fds[i].fd < 0 || poll_fds[i].revents == 0) continue;
+
+            char chunk[65536];
+            ssize_t nread = read(poll_fds[i].fd, chunk, sizeof(chunk));
+            if(nread > 0) {
+                bufs[i].insert(bufs[i].end(), chunk, chunk + nread);
+                receive_histograms(bufs[i], write_histogram);
+            } else if(nread == 0 || errno != EINTR) {
+                //Worker finished (or failed)
+                close(poll_fds[i].fd);
+                poll_fds[i].fd = -1;
+                --num_open;
+            }
+        }
+    }
+    for(const pollfd& poll_fd : poll_fds) {
+        if(poll_fd.fd >= 0) close(poll_fd.fd);
+    }
+
+    for(size_t i = 0; i < pids.size(); ++i) {
+        int status = 0;
+        pid_t ret;
+        do {
+            ret = waitpid(pids[i], &status, 0);
+        } while(ret < 0 && errno == EINTR);
+
+        if(ret < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0 || !bufs[i].empty()) {
+            std::cerr << "Output worker " << i << " (pid " << pids[i] << ") failed\n";
+            success = false;
+        }
+    }
+    return success;
+}
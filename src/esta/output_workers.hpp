@@ -0,0 +1,37 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <vector>
+
+#include "timing_graph_fwd.hpp"
+
+//A delay histogram (delay -> probability)
+typedef std::map<double,double> DelayHistogram;
+
+///Splits the nodes into num_workers groups of roughly equal total cost
+///(greedily assigning the most expensive remaining node to the least loaded group)
+///\param nodes The nodes to split
+///\param node_costs The estimated cost of each node (parallel to nodes)
+///\param num_workers The number of groups
+///\returns The nodes in each group, in their original relative order
+std::vector<std::vector<NodeId>> partition_nodes_by_cost(const std::vector<NodeId>& nodes, const std::vector<double>& node_costs, size_t num_workers);
+
+///Calculates the histograms of the specified nodes in num_workers forked worker processes.
+///
+///Each worker inherits the (read-only) analysis results and BDD state of the calling process
+///copy-on-write, so the #SAT evaluation can run on all cores without making CUDD thread-safe.
+///Each worker is limited to a share of the remaining memory budget (see MemoryGovernor::split_limit()).
+///The calculated histograms are streamed back to the calling process over pipes.
+///
+///\param nodes The nodes to calculate histograms for
+///\param node_costs The estimated cost of each node, used to balance the workers
+///\param num_workers The number of worker processes to fork
+///\param init_worker Called in each worker with all of the nodes it will calculate, before calculating any
+///\param calc_histogram Calculates the histogram of a node (called in the workers)
+///\param write_histogram Called (in the calling process) with each node's histogram as it is received
+///\returns true if all workers completed successfully
+bool fork_node_histograms(const std::vector<NodeId>& nodes, const std::vector<double>& node_costs, size_t num_workers,
+                          std::function<void(const std::vector<NodeId>&)> init_worker,
+                          std::function<DelayHistogram(NodeId)> calc_histogram,
+                          std::function<void(NodeId,const DelayHistogram&)> write_histogram);
@@ -0,0 +1,154 @@
+#pragma once
+#include <atomic>
+#include <cassert>
+#include <algorithm>
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+
+/*
+ * An append-only array of T, addressed by 32-bit indicies, which may be
+ * allocated from concurrently by multiple threads.
+ *
+ * Elements are stored in fixed size chunks (allocated on demand) so existing
+ * elements never move.  Allocation is a single atomic increment, and contiguous
+ * ranges never straddle a chunk (the tail of a chunk is skipped if required).
+ * Every chunk below size() is allocated, including those only covered by skipped ranges.
+ *
+ * An allocated range may only be written by the thread which allocated it, and
+ * must be published to other threads by some other means (e.g. joining the thread)
+ * before they read it.
+ */
+template<class T, size_t CHUNK_BITS=20>
+class ConcurrentArena {
+    public:
+        static constexpr size_t CHUNK_SIZE = size_t(1) << CHUNK_BITS;
+        static constexpr size_t MAX_CHUNKS = (uint64_t(1) << 32) >> CHUNK_BITS;
+
+        ConcurrentArena()
+            : chunks_(new std::atomic<T*>[MAX_CHUNKS])
+            , next_(0) {
+            for(size_t i = 0; i < MAX_CHUNKS; ++i) {
+                chunks_[i].store(nullptr, std::memory_order_relaxed);
+            }
+        }
+
+        ConcurrentArena(const ConcurrentArena&) = delete;
+        ConcurrentArena& operator=(const ConcurrentArena&) = delete;
+
+        ~ConcurrentArena() { clear(); }
+
+        ///Allocates num_elements contiguous elements
+        ///\returns The index of the first element
+        ///\throws std::length_error if num_elements exceeds CHUNK_SIZE
+        uint32_t allocate(size_t num_elements) {
+            assert(num_elements > 0);
+            if(num_elements > CHUNK_SIZE) {
+                throw std::length_error("ConcurrentArena can not allocate a contiguous range larger than a chunk");
+            }
+            while(true) {
+                uint64_t begin = next_.fetch_add(num_elements, std::memory_order_relaxed);
+                uint64_t end = begin + num_elements;
+                if(end > (uint64_t(1) << 32)) {
+                    throw std::length_error("ConcurrentArena exhausted its 32-bit index space");
+                }
+
+                size_t chunk_idx = begin >> CHUNK_BITS;
+                size_t end_chunk_idx = (end - 1) >> CHUNK_BITS;
+                if(chunk_idx != end_chunk_idx) {
+                    //Would straddle chunks, skip the tail of the chunk.  The skipped range still counts
+                    //towards size(), so both chunks must exist even if no allocation is ever returned
+                    //from them (e.g. if the retry also straddles)
+                    ensure_chunk(chunk_idx);
+                    ensure_chunk(end_chunk_idx);
+                    continue;
+                }
+
+                ensure_chunk(chunk_idx);
+                return begin;
+            }
+        }
+
+        T& operator[](uint32_t idx) { return chunk(idx >> CHUNK_BITS)[idx & (CHUNK_SIZE - 1)]; }
+        const T& operator[](uint32_t idx) const { return chunk(idx >> CHUNK_BITS)[idx & (CHUNK_SIZE - 1)]; }
+
+        ///\returns A pointer to the contiguous range starting at idx
+        T* data(uint32_t idx) { return &(*this)[idx]; }
+        const T* data(uint32_t idx) const { return &(*this)[idx]; }
+
+        ///\returns The number of elements allocated so far (including any skipped)
+        size_t size() const { return next_.load(std::memory_order_relaxed); }
+
+        ///Frees all elements. Not thread-safe.
+        void clear() {
+            for(size_t i = 0; i < MAX_CHUNKS; ++i) {
+                delete[] chunks_[i].exchange(nullptr, std::memory_order_relaxed);
+            }
+            next_.store(0, std::memory_order_relaxed);
+        }
+
+        ///Writes all elements (including any skipped) as raw bytes. Not thread-safe.
+        void write(std::ostream& os) const {
+            static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable elements can be written");
+
+            uint64_t num_elements = size();
+            os.write(reinterpret_cast<const char*>(&num_elements), sizeof(num_elements));
+            for(uint64_t begin = 0; begin < num_elements; begin += CHUNK_SIZE) {
+                size_t count = std::min<uint64_t>(CHUNK_SIZE, num_elements - begin);
+                os.write(reinterpret_cast<const char*>(chunk(begin >> CHUNK_BITS)), count * sizeof(T));
+            }
+        }
+
+        ///Replaces all elements with those written by write(), so they keep their indicies. Not thread-safe.
+        void read(std::istream& is) {
+            static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable elements can be read");
+
+            clear();
+
+            uint64_t num_elements = 0;
+            is.read(reinterpret_cast<char*>(&num_elements), sizeof(num_elements));
+            for(uint64_t begin = 0; is && begin < num_elements; begin += CHUNK_SIZE) {
+                //Whole chunks are allocated, so each lands at the same index as when written
+                size_t count = std::min<uint64_t>(CHUNK_SIZE, num_elements - begin);
+                uint32_t idx = allocate(count);
+                assert(idx == begin);
+                is.read(reinterpret_cast<char*>(data(idx)), count * sizeof(T));
+            }
+
+            if(!is) {
+                clear();
+                throw std::runtime_error("ConcurrentArena failed to read elements");
+            }
+        }
+
+    private:
+        T* chunk(size_t chunk_idx) const {
+            T* ptr = chunks_[chunk_idx].load(std::memory_order_acquire);
+            assert(ptr);
+            return ptr;
+        }
+
+        void ensure_chunk(size_t chunk_idx) {
+            if(chunks_[chunk_idx].load(std::memory_order_acquire)) return;
+
+            //Another thread may be racing to create the same chunk, only one wins
+            T* new_chunk = new T[CHUNK_SIZE];
+            T* expected = nullptr;
+            if(!chunks_[chunk_idx].compare_exchange_strong(expected, new_chunk, std::memory_order_acq_rel)) {
+                delete[] new_chunk;
+            }
+        }
+
+    private:
+        std::unique_ptr<std::atomic<T*>[]> chunks_;
+        std::atomic<uint64_t> next_;
+};
+
+template<class T, size_t CHUNK_BITS>
+constexpr size_t ConcurrentArena<T,CHUNK_BITS>::CHUNK_SIZE;
+
+template<class T, size_t CHUNK_BITS>
+constexpr size_t ConcurrentArena<T,CHUNK_BITS>::MAX_CHUNKS;
@@ -8,58 +8,85 @@
 
 typedef std::unordered_map<DdNode*,double> NodeTable;
 
-double CountMintermFractionRecurr(DdNode* node, NodeTable& table);
+//Persistent memo of sub-problem answers, cleared on garbage collection/reordering
+static NodeTable g_minterm_fraction_memo;
+
+static double CountMintermFractionIter(DdNode* root, NodeTable& table);
 
 double CountMintermFraction(DdNode* node) {
-    NodeTable table;
-    return CountMintermFractionRecurr(node, table);
+    return CountMintermFractionIter(node, g_minterm_fraction_memo);
 }
 
-double CountMintermFractionRecurr(DdNode* node, NodeTable& table) {
-    double frac = std::numeric_limits<double>::quiet_NaN();
+std::vector<double> CountMintermFractions(const std::vector<DdNode*>& nodes) {
+    std::vector<double> fracs;
+    fracs.reserve(nodes.size());
+    for(DdNode* node : nodes) {
+        fracs.push_back(CountMintermFractionIter(node, g_minterm_fraction_memo));
+    }
+    return fracs;
+}
 
-    auto iter = table.find(node);
+void ClearMintermFractionMemo() {
+    g_minterm_fraction_memo.clear();
+}
 
+static double CountMintermFractionIter(DdNode* root, NodeTable& table) {
+    auto iter = table.find(root);
     if(iter != table.end()) {
         //Use sub-problem from table
-        frac = iter->second;
+        return iter->second;
+    }
+
+    //Post-order walk with an explicit stack (BDDs may be deeper than the call stack allows).
+    //A node is only resolved once both its co-factors are in the table.
+    std::vector<DdNode*> stack = {root};
+    while(!stack.empty()) {
+        DdNode* node = stack.back();
+
+        if(table.count(node)) {
+            //Already resolved (reachable along multiple paths)
+            stack.pop_back();
+            continue;
+        }
 
-    } else {
         if(Cudd_IsConstant(node)) {
             assert(Cudd_V(node) == 1);
 
             //Base case (leaf node)
             if(Cudd_IsComplement(node)) {
                 //At the false node
-                frac = 0.;
+                table[node] = 0.;
             } else {
-                assert(!Cudd_IsComplement(node));
                 //At the true node
-                frac = 1.;
+                table[node] = 1.;
             }
-        } else {
-            //Recursive case (internal node)
-            assert(!Cudd_IsConstant(node));
-
-            DdNode* then_node = (Cudd_IsComplement(node)) ? Cudd_Not(Cudd_T(node)) : Cudd_T(node);
-            double frac_then = CountMintermFractionRecurr(then_node, table);
+            stack.pop_back();
+            continue;
+        }
 
-            DdNode* else_node = (Cudd_IsComplement(node)) ? Cudd_Not(Cudd_E(node)) : Cudd_E(node);
-            double frac_else = CountMintermFractionRecurr(else_node, table);
+        //Internal node
+        DdNode* then_node = (Cudd_IsComplement(node)) ? Cudd_Not(Cudd_T(node)) : Cudd_T(node);
+        DdNode* else_node = (Cudd_IsComplement(node)) ? Cudd_Not(Cudd_E(node)) : Cudd_E(node);
 
+        auto then_iter = table.find(then_node);
+        auto else_iter = table.find(else_node);
+        if(then_iter != table.end() && else_iter != table.end()) {
             // Using identity:
             //   |f| = (|f0| + |f1|) / 2
             //
             // where |f| is the number of minterms
             // and f0 and f1 are the co-factors of f
-            frac = (frac_then + frac_else) / 2.;
+            double frac = (then_iter->second + else_iter->second) / 2.;
 
+            //Store sub-problem answer in table
+            table[node] = frac;
+            stack.pop_back();
+        } else {
+            //Resolve the co-factors first
+            if(else_iter == table.end()) stack.push_back(else_node);
+            if(then_iter == table.end()) stack.push_back(then_node);
         }
-
-        //Store sub-problem answer in table
-        auto result = table.insert(std::make_pair(node, frac)); 
-        assert(result.second); //Was inserted
     }
-    return frac;
-}
 
+    return table[root];
+}
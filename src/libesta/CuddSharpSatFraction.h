@@ -1,4 +1,21 @@
 #pragma once
+#include <vector>
+
 struct DdNode;
 
+///\returns The fraction of minterms which satisfy node
+///
+///Results for each (sub-)node are memoized across calls, since consecutive functions
+///(e.g. the tags at a node) typically share most of their sub-BDDs.  Node addresses
+///are only stable until CUDD garbage collects or reorders, so the memo must be cleared
+///at those points (see ClearMintermFractionMemoHook()).
+///Not thread-safe.
 double CountMintermFraction(DdNode* node);
+
+///\returns The fraction of minterms which satisfy each of nodes, counted in a single sweep
+///(sharing the memo between them)
+std::vector<double> CountMintermFractions(const std::vector<DdNode*>& nodes);
+
+///Discards all memoized minterm fractions
+///\see ClearMintermFractionMemoHook()
+void ClearMintermFractionMemo();
@@ -9,19 +9,42 @@
 #include <unordered_set>
 #include "transition_filters.hpp"
 #include "TagPermutationGenerator.hpp"
+#include "NodeEvalContext.hpp"
+#include "truth_table.hpp"
+
+//How the input tags at each node are evaluated
+enum class NodeEvalMode {
+    PERMUTATION, //Evaluate every permutation of input tags (exact, cost is the product of the input tag counts)
+    CONVOLUTION //Evaluate every combination of input transitions, max-convolving the input arrival times (approximate)
+};
 
 template<class BaseAnalysisMode = BaseAnalysisMode, class Tags=TimingTags>
 class ExtSetupAnalysisMode : public BaseAnalysisMode {
     public:
         typedef typename Tags::Tag Tag;
+        typedef Tags TagSet;
 
         //External tag access
         const Tags& setup_data_tags(NodeId node_id) const { return setup_data_tags_[node_id]; }
         const Tags& setup_clock_tags(NodeId node_id) const { return setup_clock_tags_[node_id]; }
         //BDD build_xfunc(const TimingGraph& tg, const ExtTimingTag& tag, const NodeId node_id);
 
-        void set_xfunc_cache_size(size_t val) { bdd_cache_.set_capacity(val); }
+        void set_xfunc_cache_node_budget(size_t val) { bdd_cache_.set_cost_capacity(val); }
         void reset_xfunc_cache();
+
+        void set_node_eval_mode(NodeEvalMode val) { node_eval_mode_ = val; }
+        NodeEvalMode node_eval_mode() const { return node_eval_mode_; }
+
+        ///Replaces the tags of every node with previously calculated ones (e.g. loaded from a checkpoint),
+        ///rather than calculating them.  The tags (and their scenarios) must be stored in g_scenario_store.
+        ///\param data_tags The data tags of each node
+        ///\param clock_tags The clock tags of each node
+        void restore_tags(const TimingGraph& tg, std::vector<Tags> data_tags, std::vector<Tags> clock_tags);
+
+        ///\returns The tags replaced (i.e. whose timing changed) during the last incremental update.
+        ///Any results cached for these tags (e.g. xfunc BDDs) are no longer valid.
+        ///\see IncrementalEstaTimingAnalyzer::update_timing()
+        const std::vector<typename Tag::cptr>& replaced_tags() const { return replaced_tags_; }
     protected:
         //Internal operations for performing setup analysis to satisfy the BaseAnalysisMode interface
         void initialize_traversal(const TimingGraph& tg);
@@ -29,6 +52,20 @@ class ExtSetupAnalysisMode : public BaseAnalysisMode {
         template<class DelayCalc>
         void pre_traverse_node(const TimingGraph& tg, const TimingConstraints& tc, const DelayCalc& dc, const NodeId node_id);
 
+        /*
+         * Incremental update operations (see IncrementalEstaTimingAnalyzer::update_timing())
+         */
+        ///Prepares for an incremental update
+        void initialize_update(const TimingGraph& tg);
+
+        ///Clears node_id's tags so it can be re-evaluated
+        void invalidate_node(const NodeId node_id);
+
+        ///Replaces any of node_id's re-evaluated tags which are identical to its previous tags
+        ///(same timing and switching scenarios) with the previous tags, preserving their identity
+        ///\returns true if any of node_id's tags changed
+        bool revalidate_node(const NodeId node_id);
+
         /*
          *template<class DelayCalc>
          *void forward_traverse_edge(const TimingGraph& tg, const DelayCalc& dc, const NodeId node_id, const EdgeId edge_id);
@@ -37,6 +74,74 @@ class ExtSetupAnalysisMode : public BaseAnalysisMode {
         template<class DelayCalc>
         void forward_traverse_finalize_node(const TimingGraph& tg, const TimingConstraints& tc, const DelayCalc& dc, const NodeId node_id, const TagReducer& tag_reducer, size_t max_output_tags);
 
+        ///Evaluates the node using the specified logic function and evaluation context.
+        ///Only the tags of node_id are modified, so distinct nodes may be evaluated concurrently
+        ///provided each thread uses its own context (and manager).
+        ///\param node_func The node's logic function (may be a copy transferred into a different manager)
+        ///\param eval_ctx The evaluation context, whose manager owns node_func
+        template<class DelayCalc>
+        void forward_traverse_finalize_node(const TimingGraph& tg, const TimingConstraints& tc, const DelayCalc& dc, const NodeId node_id, const TagReducer& tag_reducer, size_t max_output_tags, const BDD& node_func, NodeEvalContext& eval_ctx);
+
+        ///Propagates the clock tags arriving at node_id
+        ///\returns The data tags arriving at each input of node_id
+        template<class DelayCalc>
+        std::vector<Tags> forward_traverse_input_tags(const TimingGraph& tg, const DelayCalc& dc, const NodeId node_id);
+
+        ///Evaluates the input tag permutations produced by tag_permutation_generator
+        ///\param node_func The node's logic function
+        ///\param eval_ctx The evaluation context, whose manager owns node_func
+        ///\param tag_permutation_generator The permutations to evaluate (may cover only a range of the node's permutations)
+        ///\param sink_tags The tag set into which the resulting output tags are merged
+        template<class DelayCalc>
+        void evaluate_permutations(const TimingGraph& tg, const DelayCalc& dc, const NodeId node_id, const BDD& node_func, NodeEvalContext& eval_ctx, TagPermutationGenerator& tag_permutation_generator, Tags& sink_tags);
+
+        ///Evaluates the input tags by transition class (see NodeEvalMode::CONVOLUTION).
+        ///
+        ///Each input's tags are grouped by transition type.  For each combination of input transitions
+        ///the output arrival times are the max-convolution of the sensitized inputs' (sorted) arrival times,
+        ///and the scenarios producing each output arrival are recorded as products of per-input tag sets.
+        ///\param node_func The node's logic function
+        ///\param eval_ctx The evaluation context, whose manager owns node_func
+        ///\param src_data_tag_sets The data tags arriving at each input
+        ///\param sink_tags The tag set into which the resulting output tags are merged
+        template<class DelayCalc>
+        void evaluate_transition_classes(const TimingGraph& tg, const DelayCalc& dc, const NodeId node_id, const BDD& node_func, NodeEvalContext& eval_ctx, const std::vector<Tags>& src_data_tag_sets, Tags& sink_tags);
+
+        ///Merges scenarios (with the specified output transition and arrival) into sink_tags
+        void merge_scenarios(Tags& sink_tags, TransitionType output_transition, const Time& scenario_arr, NodeId launch_node, ScenarioId scenarios);
+
+        ///Determines the output transition for a combination of input transitions, and which inputs
+        ///are sensitized (independent of their arrival order).
+        ///
+        ///A static input is sensitized if the function depends on it, and a dynamic input is sensitized
+        ///if the function depends on it once the static inputs are applied.  This is conservative: an
+        ///input filtered for some arrival orders may still be considered sensitized.
+        ///
+        ///As when evaluating permutations, the output is a dynamic (Rise/Fall) transition if any sensitized
+        ///input is dynamic (even if the initial and final values match, e.g. a glitch), and otherwise static.
+        ///\param f The node function (either a BDD or TruthTable)
+        ///\param input_transitions The transition of each data input
+        ///\param sensitized Set to whether each data input is sensitized
+        ///\returns The output transition
+        template<class Func>
+        TransitionType evaluate_transition_class(const NodeEvalContext& eval_ctx, const Func& f, const std::vector<int>& data_edge_idxs, const std::vector<TransitionType>& input_transitions, std::vector<char>& sensitized);
+
+        ///Applies the data input transitions (in arrival order) to the node function until it is determined
+        ///\param first_input The first input to apply (applied_funcs[first_input] must be up-to-date)
+        ///\param applied_funcs The function before applying each input (either BDDs or TruthTables)
+        ///\param unfiltered Set to whether applying each input changed the function
+        ///\returns The number of inputs applied
+        template<class Func>
+        size_t apply_input_transitions(const NodeEvalContext& eval_ctx, const std::vector<const Tag*>& src_tags, const std::vector<int>& data_edge_idxs, const std::vector<size_t>& arrival_order, size_t first_input, std::vector<Func>& applied_funcs, std::vector<char>& unfiltered);
+
+        ///Merges tag sets produced by evaluating disjoint permutation ranges into node_id's tags
+        ///\param partial_tag_sets The partial tag sets, ordered by their permutation ranges
+        void merge_partial_tags(const NodeId node_id, const std::vector<Tags>& partial_tag_sets);
+
+        ///Replaces the tags in tags identical to those in prev_tags, recording any unused prev_tags as replaced
+        ///\returns true if the tags changed
+        bool revalidate_tags(Tags& tags, const Tags& prev_tags);
+
         /*
          *template<class DelayCalc>
          *void backward_traverse_edge(const TimingGraph& tg, const DelayCalc& dc, const NodeId node_id, const EdgeId edge_id);
@@ -49,9 +154,20 @@ class ExtSetupAnalysisMode : public BaseAnalysisMode {
 
         Time map_to_delay_bin(Time delay, const double delay_bin_size);
 
-        BDD apply_restriction(int var_idx, TransitionType input_trans, BDD f);
+        BDD apply_restriction(const Cudd& cudd, int var_idx, TransitionType input_trans, BDD f);
+        TruthTable apply_restriction(const Cudd& /*cudd*/, int var_idx, TransitionType input_trans, TruthTable f) { return tt_restrict(f, var_idx, input_trans); }
 
-        TagPermutationGenerator reduce_permutations(const TimingGraph& tg, NodeId node_id, std::vector<Tags> src_data_tag_sets, size_t max_permutations, double delay_bin_size_scale_fac, const TagReducer& tag_reducer);
+        static bool is_constant(const BDD& f) { return f.IsOne() || f.IsZero(); }
+        static bool is_constant(TruthTable f) { return tt_is_one(f) || tt_is_zero(f); }
+        static bool is_one(const BDD& f) { return f.IsOne(); }
+        static bool is_one(TruthTable f) { return tt_is_one(f); }
+
+        TagPermutationGenerator reduce_permutations(const TimingGraph& tg, NodeId node_id, std::vector<Tags> src_data_tag_sets, size_t max_permutations, double delay_bin_size_scale_fac, const TagReducer& tag_reducer, std::ostream& log);
+
+        ///Plans the delay bin size each input should be re-merged at to reduce the number of
+        ///permutations below max_permutations, with the least added delay error
+        ///\returns The bin size for each input (zero if the input should not be reduced)
+        std::vector<double> plan_input_bin_sizes(const TimingGraph& tg, NodeId node_id, const std::vector<Tags>& src_data_tag_sets, size_t max_permutations, double delay_bin_size_scale_fac, const TagReducer& tag_reducer);
     protected:
 
         //Setup tag data storage
@@ -64,9 +180,22 @@ class ExtSetupAnalysisMode : public BaseAnalysisMode {
 
         NextStateTransitionFilter transition_filter_;
 
-        ObjectCacheMap<std::pair<NodeId,TransitionType>,BDD> bdd_cache_;
+        struct NodeTransHash {
+            size_t operator()(const std::pair<NodeId,TransitionType>& key) const { return (size_t(key.first) << 8) | size_t(key.second); }
+        };
+        ObjectCache<std::pair<NodeId,TransitionType>,BDD,NodeTransHash> bdd_cache_;
+
+        //Evaluation context used when evaluating nodes with the global manager
+        std::unique_ptr<NodeEvalContext> eval_ctx_;
 
         double delay_bin_size_scale_fac_;
+
+        NodeEvalMode node_eval_mode_ = NodeEvalMode::PERMUTATION;
+
+        //Incremental update state
+        Tags prev_node_data_tags_; //Tags of the node being re-evaluated before invalidate_node()
+        Tags prev_node_clock_tags_;
+        std::vector<typename Tag::cptr> replaced_tags_;
 };
 
 
@@ -1,7 +1,12 @@
 #include <chrono>
+#include <cmath>
+#include <queue>
 #include <sstream>
+#include <tuple>
 #include "transition_eval.hpp"
 #include "util.hpp"
+#include "MemoryGovernor.hpp"
+#include "ReorderScheduler.hpp"
 #include "transition_eval.hpp"
 
 //Print out detailed information about tags during analysis
@@ -13,6 +18,13 @@
 
 const double PERMUTATION_WARNING_THRESHOLD = 10e6;
 
+//The factor by which an input's delay bin size grows each time it is reduced
+const double DELAY_BIN_SIZE_SCALE_FAC = 1.2;
+
+//The smallest bin size (as a fraction of the maximum input tag delay) considered when reducing
+//permutations, if the tag reducer does not bin by default
+const double MIN_PLANNER_BIN_SIZE_FRAC = 1e-3;
+
 extern EtaStats g_eta_stats;
 
 template<class BaseAnalysisMode, class Tags>
@@ -24,7 +36,9 @@ void ExtSetupAnalysisMode<BaseAnalysisMode,Tags>::reset_xfunc_cache() {
     //Reset the default re-order size
     //Re-ordering really big BDDs is slow (re-order time appears to be quadratic in size)
     //So cap the size for re-ordering to something reasonable when re-starting
-    auto next_reorder = std::min(g_cudd.ReadNextReordering(), 100004u);
+    //(scaled by the scheduler's back-off, so unproductive reordering is not restarted)
+    g_reorder_scheduler.check_budget(g_cudd.getManager());
+    auto next_reorder = std::min(g_cudd.ReadNextReordering(), g_reorder_scheduler.scaled_threshold(100004u));
     g_cudd.SetNextReordering(next_reorder);
 }
 
@@ -36,6 +50,84 @@ void ExtSetupAnalysisMode<BaseAnalysisMode,Tags>::initialize_traversal(const Tim
     //Initialize
     setup_data_tags_ = std::vector<Tags>(tg.num_nodes());
     setup_clock_tags_ = std::vector<Tags>(tg.num_nodes());
+
+    //Release the tags and scenarios of any previous analysis
+    g_scenario_store.clear();
+
+    eval_ctx_.reset(new NodeEvalContext(g_cudd));
+}
+
+template<class BaseAnalysisMode, class Tags>
+void ExtSetupAnalysisMode<BaseAnalysisMode,Tags>::restore_tags(const TimingGraph& tg, std::vector<Tags> data_tags, std::vector<Tags> clock_tags) {
+    ASSERT(data_tags.size() == tg.num_nodes());
+    ASSERT(clock_tags.size() == tg.num_nodes());
+
+    setup_data_tags_ = std::move(data_tags);
+    setup_clock_tags_ = std::move(clock_tags);
+
+    eval_ctx_.reset(new NodeEvalContext(g_cudd));
+}
+
+template<class BaseAnalysisMode, class Tags>
+void ExtSetupAnalysisMode<BaseAnalysisMode,Tags>::initialize_update(const TimingGraph& /*tg*/) {
+    replaced_tags_.clear();
+}
+
+template<class BaseAnalysisMode, class Tags>
+void ExtSetupAnalysisMode<BaseAnalysisMode,Tags>::invalidate_node(const NodeId node_id) {
+    //Keep the previous tags so they can be re-used if unchanged
+    prev_node_data_tags_ = setup_data_tags_[node_id];
+    prev_node_clock_tags_ = setup_clock_tags_[node_id];
+
+    setup_data_tags_[node_id].clear();
+    setup_clock_tags_[node_id].clear();
+}
+
+template<class BaseAnalysisMode, class Tags>
+bool ExtSetupAnalysisMode<BaseAnalysisMode,Tags>::revalidate_node(const NodeId node_id) {
+    bool data_changed = revalidate_tags(setup_data_tags_[node_id], prev_node_data_tags_);
+    bool clock_changed = revalidate_tags(setup_clock_tags_[node_id], prev_node_clock_tags_);
+
+    prev_node_data_tags_.clear();
+    prev_node_clock_tags_.clear();
+
+    return data_changed || clock_changed;
+}
+
+template<class BaseAnalysisMode, class Tags>
+bool ExtSetupAnalysisMode<BaseAnalysisMode,Tags>::revalidate_tags(Tags& tags, const Tags& prev_tags) {
+    bool changed = (tags.num_tags() != prev_tags.num_tags());
+
+    std::vector<char> reused(prev_tags.num_tags(), false);
+    for(auto iter = tags.begin(); iter != tags.end(); ++iter) {
+        typename Tag::cptr tag = *iter;
+
+        //A tag is unchanged if it has the same timing and is generated by the same input tags.
+        //Since the input tags are themselves only kept if unchanged, anything derived from the
+        //previous tag (e.g. its xfunc) remains valid
+        auto prev_iter = prev_tags.find_matching_tag(tag);
+        if(prev_iter != prev_tags.end()) {
+            size_t prev_idx = prev_iter - prev_tags.begin();
+            typename Tag::cptr prev_tag = *prev_iter;
+
+            if(!reused[prev_idx]
+               && prev_tag->launch_node() == tag->launch_node()
+               && g_scenario_store.same_scenarios(prev_tag->scenarios(), tag->scenarios())) {
+                tags.replace_tag(iter, *prev_iter);
+                reused[prev_idx] = true;
+                continue;
+            }
+        }
+        changed = true;
+    }
+
+    for(size_t i = 0; i < prev_tags.num_tags(); ++i) {
+        if(!reused[i]) {
+            replaced_tags_.push_back(*(prev_tags.begin() + i));
+        }
+    }
+
+    return changed;
 }
 
 template<class BaseAnalysisMode, class Tags>
@@ -112,9 +204,82 @@ void ExtSetupAnalysisMode<BaseAnalysisMode,Tags>::pre_traverse_node(const Timing
 template<class BaseAnalysisMode, class Tags>
 template<class DelayCalcType>
 void ExtSetupAnalysisMode<BaseAnalysisMode,Tags>::forward_traverse_finalize_node(const TimingGraph& tg, const TimingConstraints& tc, const DelayCalcType& dc, const NodeId node_id, const TagReducer& tag_reducer, size_t max_permutations) {
+    //By default evaluate with the timing graph's node function in the global manager
+    forward_traverse_finalize_node(tg, tc, dc, node_id, tag_reducer, max_permutations, tg.node_func(node_id), *eval_ctx_);
+
+    //No global manager operations are in progress between nodes
+    g_memory_governor.check();
+}
+
+template<class BaseAnalysisMode, class Tags>
+template<class DelayCalcType>
+void ExtSetupAnalysisMode<BaseAnalysisMode,Tags>::forward_traverse_finalize_node(const TimingGraph& tg, const TimingConstraints& tc, const DelayCalcType& dc, const NodeId node_id, const TagReducer& tag_reducer, size_t max_permutations, const BDD& node_func, NodeEvalContext& eval_ctx) {
     //Chain to base class
     BaseAnalysisMode::forward_traverse_finalize_node(tg, tc, dc, node_id);
 
+    //Handle clock tags and collect the data tags from each input
+    std::vector<Tags> src_data_tag_sets = forward_traverse_input_tags(tg, dc, node_id);
+
+    //Evaluate the input tags at this node
+    if(src_data_tag_sets.size() > 0) {
+
+        //The output tag set for this node
+        Tags& sink_tags = setup_data_tags_[node_id];
+
+#ifdef TAG_DEBUG
+        std::cout << "Evaluating Node: " << node_id << " " << tg.node_type(node_id) << "\n";
+
+        //Print out the input tags to this node
+        for(size_t i = 0; i < src_data_tag_sets.size(); ++i) {
+            std::cout << "\tInput " << i << ": ";
+                for(const auto tag : src_data_tag_sets[i]) {
+                    std::cout << tag->trans_type() << "@" << tag->arr_time() << " "; 
+                }
+            std::cout << "\n";
+        }
+#endif
+
+        if(node_eval_mode_ == NodeEvalMode::CONVOLUTION) {
+            //The cost does not grow with the product of the input tag counts, so no reduction is required
+            evaluate_transition_classes(tg, dc, node_id, node_func, eval_ctx, src_data_tag_sets, sink_tags);
+        } else {
+            //Generate all tag transition permutations
+            TagPermutationGenerator tag_permutation_generator = reduce_permutations(tg, node_id, src_data_tag_sets, max_permutations, DELAY_BIN_SIZE_SCALE_FAC, tag_reducer, *eval_ctx.log);
+
+            evaluate_permutations(tg, dc, node_id, node_func, eval_ctx, tag_permutation_generator, sink_tags);
+        }
+
+#ifdef TAG_DEBUG
+        //The output tags from this node
+        {
+            std::cout << "\tOutput Tags (unreduced):\n";
+            int i_out_tag = 0;
+            for(auto sink_tag : sink_tags) {
+                std::cout << "\t\t" << sink_tag->trans_type() << "@" << sink_tag->arr_time().value() << " cases: " << sink_tag->num_scenarios() << std::endl;
+                i_out_tag++;
+            }
+        }
+#endif
+
+        sink_tags = tag_reducer.merge_tags(node_id, sink_tags);
+
+#ifdef TAG_DEBUG
+        //The output tags from this node
+        {
+            std::cout << "\tOutput Tags (reduced):\n";
+            int i_out_tag = 0;
+            for(auto sink_tag : sink_tags) {
+                std::cout << "\t\t" << sink_tag->trans_type() << "@" << sink_tag->arr_time().value() << " cases: " << sink_tag->num_scenarios() << std::endl;
+                i_out_tag++;
+            }
+        }
+#endif
+    }
+}
+
+template<class BaseAnalysisMode, class Tags>
+template<class DelayCalcType>
+std::vector<Tags> ExtSetupAnalysisMode<BaseAnalysisMode,Tags>::forward_traverse_input_tags(const TimingGraph& tg, const DelayCalcType& dc, const NodeId node_id) {
     //Walk through all the inputs handling clock tags and collecting data tags
     std::vector<Tags> src_data_tag_sets;
     for(int edge_idx = 0; edge_idx < tg.num_node_in_edges(node_id); edge_idx++) {
@@ -165,233 +330,540 @@ void ExtSetupAnalysisMode<BaseAnalysisMode,Tags>::forward_traverse_finalize_node
         }
     }
 
-    //Evaluate the input tags at this node
-    if(src_data_tag_sets.size() > 0) {
+    return src_data_tag_sets;
+}
 
-        //The output tag set for this node
-        Tags& sink_tags = setup_data_tags_[node_id];
+template<class BaseAnalysisMode, class Tags>
+template<class DelayCalcType>
+void ExtSetupAnalysisMode<BaseAnalysisMode,Tags>::evaluate_permutations(const TimingGraph& tg, const DelayCalcType& dc, const NodeId node_id, const BDD& node_func, NodeEvalContext& eval_ctx, TagPermutationGenerator& tag_permutation_generator, Tags& sink_tags) {
+    //Collect up the data inputs (we skip edges from FF_CLOCK since they never carry data arrivals)
+    //
+    //Note that the generator's inputs correspond to the node's input edges
+    std::vector<int> data_edge_idxs; //Used to find the correct BDD var to restrict, and the input's tag
+    std::vector<EdgeId> data_edge_ids; //Used to get the edge delay
+    std::vector<int> input_data_pos(tag_permutation_generator.num_inputs(), -1); //Generator input -> data input position
+    for(int edge_idx = 0; edge_idx < tg.num_node_in_edges(node_id); edge_idx++) {
+        EdgeId edge_id = tg.node_in_edge(node_id, edge_idx);
 
+        NodeId src_node_id = tg.edge_src_node(edge_id);
+        if(tg.node_type(src_node_id) == TN_Type::FF_CLOCK) {
+            continue;
+        }
 
-        const BDD& node_func = tg.node_func(node_id);
+        assert(edge_idx < (int) tag_permutation_generator.num_inputs());
+        input_data_pos[edge_idx] = data_edge_idxs.size();
+        data_edge_idxs.push_back(edge_idx);
+        data_edge_ids.push_back(edge_id);
+    }
+    const size_t num_data_inputs = data_edge_idxs.size();
+    assert(num_data_inputs > 0);
 
-#ifdef TAG_DEBUG
-        std::cout << "Evaluating Node: " << node_id << " " << tg.node_type(node_id) << " (" << node_func << ")\n";
+    //The current permutation (indexed by input edge)
+    const std::vector<const Tag*>& src_tags = tag_permutation_generator.current();
 
-        //Print out the input tags to this node
-        for(size_t i = 0; i < src_data_tag_sets.size(); ++i) {
-            std::cout << "\tInput " << i << ": ";
-                for(const auto tag : src_data_tag_sets[i]) {
-                    std::cout << tag->trans_type() << "@" << tag->arr_time() << " "; 
-                }
-            std::cout << "\n";
-        }
-#endif
+    //The evaluation state, which is re-used across permutations.
+    //
+    //The data inputs are applied in order of increasing arrival time (ties are broken by input
+    //position so the order is unique).  Since the generator changes only one input's tag per
+    //step, we maintain the order incrementally, and re-use the prefix of restricted functions
+    //which precede the changed input.
+    std::vector<size_t> arrival_order(num_data_inputs); //Data input positions sorted by arrival
+    std::vector<size_t> arrival_rank(num_data_inputs); //Data input position -> index in arrival_order
+    std::vector<BDD> applied_funcs; //The function before applying arrival_order[i]
+    std::vector<TruthTable> applied_tts; //As applied_funcs, for nodes evaluated with truth tables
+    std::vector<char> unfiltered(num_data_inputs, false); //Did applying arrival_order[i] change the function
+    size_t num_applied = 0; //Number of inputs applied before the function became constant
+    size_t num_valid = 0; //Length of the prefix of applied_funcs/unfiltered which is up-to-date
+    std::vector<char> input_unfiltered(num_data_inputs, false); //Data input position -> not filtered in the current permutation
+    std::vector<TagId> scenario_tag_ids(num_data_inputs); //The input tags of the current permutation
+
+    //Small nodes are evaluated using their truth table (bit operations) rather than their BDD
+    const bool use_truth_table = tg.node_has_truth_table(node_id);
+    if(use_truth_table) {
+        applied_tts.resize(num_data_inputs + 1);
+        applied_tts[0] = tg.node_truth_table(node_id);
+    } else {
+        applied_funcs.resize(num_data_inputs + 1);
+        applied_funcs[0] = node_func;
+    }
 
-        size_t i_case = 0;
-        const double delay_bin_size_scale_fac = 1.2;
+    //Results for other small nodes are cached per node function (the lookup is much cheaper than the restrictions)
+    bool cacheable = !use_truth_table && TransitionFilterCache::can_cache(num_data_inputs, data_edge_idxs.back());
+    TransitionFilterCache::Table* filter_table = nullptr;
+    if(cacheable) {
+        filter_table = &eval_ctx.filter_cache.function_table(node_func);
+    }
 
-        //Generate all tag transition permutations
-        TagPermutationGenerator tag_permutation_generator = reduce_permutations(tg, node_id, src_data_tag_sets, max_permutations, delay_bin_size_scale_fac, tag_reducer);
+    auto arrives_before = [&](size_t lhs_pos, size_t rhs_pos) {
+        const Time& lhs_arr = src_tags[data_edge_idxs[lhs_pos]]->arr_time();
+        const Time& rhs_arr = src_tags[data_edge_idxs[rhs_pos]]->arr_time();
+        if(lhs_arr < rhs_arr) return true;
+        if(rhs_arr < lhs_arr) return false;
+        return lhs_pos < rhs_pos;
+    };
 
-        while(!tag_permutation_generator.done()) {
-            std::vector<typename Tag::cptr> src_tags = tag_permutation_generator.next();
+    size_t i_case = 0;
+    for(; !tag_permutation_generator.done(); tag_permutation_generator.advance()) {
 
 #ifdef TAG_DEBUG
-            std::cout << "\tCase " << i_case << "\n";
-            std::cout << "\t\tinputs: ";
-            for(int edge_idx = 0; edge_idx < tg.num_node_in_edges(node_id); edge_idx++) {
-                const auto& tag = src_tags[edge_idx];
-                std::cout << tag->trans_type();
-                std::cout << "@" << tag->arr_time().value();
-                std::cout << " ";
-            }
-            std::cout << "\n";
+        std::cout << "\tCase " << i_case << "\n";
+        std::cout << "\t\tinputs: ";
+        for(const Tag* tag : src_tags) {
+            std::cout << tag->trans_type();
+            std::cout << "@" << tag->arr_time().value();
+            std::cout << " ";
+        }
+        std::cout << "\n";
 #endif
-            //Sanity checks on incomming tags
-            assert(src_tags.size() > 0);
-            assert((int) src_tags.size() <= tg.num_node_in_edges(node_id)); //May be less than if we are ignoring non-data edges like those from FF_CLOCK to FF_SINK
-
-            //Initialize the tag representing the behaviour for the current set of input transitions
-            auto scenario_tag = Tag::make_ptr();
-            scenario_tag->set_clock_domain(0); //Currently only single-clock supported
-            scenario_tag->set_arr_time(Time(0.)); //Set a default arrival to avoid nan
-
-            //Keep a collection of the input tags (note that this may be different from the src tags
-            //due to skipping clock tags and filtering inputs
-            std::vector<typename Tag::cptr> input_tags;
-
-            //Collect up the edge indicies and associated tags
-            std::vector<std::tuple<int,EdgeId, typename Tag::cptr>> edge_idx_id_tag_tuples;
-            for(int edge_idx = 0; edge_idx < tg.num_node_in_edges(node_id); edge_idx++) {
-                EdgeId edge_id = tg.node_in_edge(node_id, edge_idx);
-
-                NodeId src_node_id = tg.edge_src_node(edge_id);
-                if(tg.node_type(src_node_id) == TN_Type::FF_CLOCK) {
-                    continue; //We skip edges from FF_CLOCK since they never carry data arrivals
-                }
-
-                typename Tag::cptr src_tag = src_tags[edge_idx];
-
-                input_tags.push_back(src_tag); //We still need to track this input for #SAT calculation purposes
-
-                edge_idx_id_tag_tuples.emplace_back(edge_idx, edge_id, src_tag);
+        //Sanity checks on incomming tags
+        assert(src_tags.size() > 0);
+        assert((int) src_tags.size() <= tg.num_node_in_edges(node_id)); //May be less than if we are ignoring non-data edges like those from FF_CLOCK to FF_SINK
+
+        //Update the arrival order
+        size_t changed_input = tag_permutation_generator.changed_input();
+        if(changed_input == TagPermutationGenerator::ALL_INPUTS) {
+            //Re-build from scratch
+            for(size_t pos = 0; pos < num_data_inputs; ++pos) {
+                arrival_order[pos] = pos;
+            }
+            std::sort(arrival_order.begin(), arrival_order.end(), arrives_before);
+            for(size_t i = 0; i < num_data_inputs; ++i) {
+                arrival_rank[arrival_order[i]] = i;
+            }
+            num_valid = 0;
+
+        } else if(input_data_pos[changed_input] >= 0) {
+            //Only one input changed, move it to its new position
+            size_t old_rank = arrival_rank[input_data_pos[changed_input]];
+            size_t rank = old_rank;
+            while(rank > 0 && arrives_before(arrival_order[rank], arrival_order[rank-1])) {
+                std::swap(arrival_order[rank], arrival_order[rank-1]);
+                arrival_rank[arrival_order[rank]] = rank;
+                --rank;
+            }
+            while(rank + 1 < num_data_inputs && arrives_before(arrival_order[rank+1], arrival_order[rank])) {
+                std::swap(arrival_order[rank], arrival_order[rank+1]);
+                arrival_rank[arrival_order[rank]] = rank;
+                ++rank;
             }
+            arrival_rank[arrival_order[rank]] = rank;
 
-            //Sort the edges/tags by the associated input tag arrival times (asscending)
-            auto order = [&src_tags] (const std::tuple<int, EdgeId, typename Tag::cptr>& lhs_edge_id_tag_pair,
-                                      const std::tuple<int, EdgeId, typename Tag::cptr>& rhs_edge_id_tag_pair) {
-                return std::get<2>(lhs_edge_id_tag_pair)->arr_time() < std::get<2>(rhs_edge_id_tag_pair)->arr_time();
-            };
-            std::sort(edge_idx_id_tag_tuples.begin(), edge_idx_id_tag_tuples.end(), order);
+            //Inputs applied before the changed input are unaffected
+            num_valid = std::min(num_valid, std::min(old_rank, rank));
+        }
 
-            //Evaluate all the inputs and determine if are filtered
-            // Note that the previous sorting means this occurs in order of increase arrival time (so causality is preserved)
-            BDD f = node_func;
-            bool only_static_inputs_applied = true;
-            std::vector<std::tuple<EdgeId, typename Tag::cptr>> unfiltered_inputs;
-            for(auto& edge_idx_id_tag_tuple : edge_idx_id_tag_tuples) {
-                //Check if the function has already been determined.
-                //If it has we don't need to look at any more inputs
-                if(f.IsOne() || f.IsZero()) {
+        //Determine the output transition and which inputs are filtered.
+        //
+        //The result depends only on the input transitions in arrival order, so we first check
+        //whether it has already been evaluated for this sequence
+        uint64_t cache_key = 0;
+        bool use_cache = cacheable;
+        if(use_cache) {
+            for(size_t i = 0; i < num_data_inputs; ++i) {
+                int edge_idx = data_edge_idxs[arrival_order[i]];
+                TransitionType trans = src_tags[edge_idx]->trans_type();
+                if(trans != TransitionType::RISE && trans != TransitionType::FALL
+                   && trans != TransitionType::HIGH && trans != TransitionType::LOW) {
+                    use_cache = false;
                     break;
                 }
+                cache_key = TransitionFilterCache::append_key(cache_key, edge_idx, trans);
+            }
+        }
 
+        TransitionType output_transition = TransitionType::UNKOWN;
+        const TransitionFilterCache::Result* cached_result = nullptr;
+        if(use_cache) {
+            cached_result = TransitionFilterCache::find(*filter_table, cache_key);
+        }
 
-                int edge_idx; //Used to the the correct BDD var to restrict
-                EdgeId edge_id; //Used to get the edge delay
-                typename Tag::cptr src_tag; //To retreive the transition and arrival time
-                std::tie(edge_idx, edge_id, src_tag) = edge_idx_id_tag_tuple;
-
-
-                //We now apply this inputs transition to restrict the logic function
-                BDD f_new = apply_restriction(edge_idx, src_tag->trans_type(), f);
-
-                //If the variable had no effect on the logic output we do not need to consider its
-                //delay impact
-                if(f_new == f) {
-#ifdef TAG_DEBUG
-                    std::cout << "\t\tFiltered: input " << edge_idx << std::endl;
-#endif
-                    continue; //No effect on output delay
-                }
-
-                assert(f_new != f);
+        if(cached_result) {
+            output_transition = cached_result->output_transition;
+            for(size_t pos = 0; pos < num_data_inputs; ++pos) {
+                input_unfiltered[pos] = (cached_result->unfiltered_inputs >> data_edge_idxs[pos]) & 1;
+            }
+        } else {
+            //Evaluate the inputs (in order of increasing arrival time, so causality is preserved) and
+            //determine if they are filtered. 
+            //
+            //If the changed input was applied after the function was already determined there is nothing
+            //to re-evaluate (the walk stops immediately at the constant function).
+            size_t first_input = std::min(num_valid, num_applied);
+            bool output_one = false;
+            if(use_truth_table) {
+                num_applied = apply_input_transitions(eval_ctx, src_tags, data_edge_idxs, arrival_order, first_input, applied_tts, unfiltered);
+                output_one = tt_is_one(applied_tts[num_applied]);
+            } else {
+                num_applied = apply_input_transitions(eval_ctx, src_tags, data_edge_idxs, arrival_order, first_input, applied_funcs, unfiltered);
+                output_one = applied_funcs[num_applied].IsOne();
+            }
+            num_valid = num_data_inputs;
 
-                //The logic function changed when the current input was applied.
-                //
-                //We update the 'current' logic function at this node with the newly restricted one
-                f = f_new;
+            //Record whether any non-filtered inputs were dynamic transitions (i.e. Rise/Fall)
+            //this impacts what the output transition is
+            bool only_static_inputs_applied = true;
+            std::fill(input_unfiltered.begin(), input_unfiltered.end(), false);
+            for(size_t i = 0; i < num_applied; ++i) {
+                if(!unfiltered[i]) continue;
 
-                //And note this input so it will be used in delay calculation
-                unfiltered_inputs.emplace_back(edge_id, src_tag);
+                input_unfiltered[arrival_order[i]] = true;
 
-                //Also Record whether any non-filtered inputs were dynamic transitions (i.e. Rise/Fall)
-                //this impacts what the output transition is
-                if(src_tag->trans_type() == TransitionType::RISE || src_tag->trans_type() == TransitionType::FALL) {
+                TransitionType trans = src_tags[data_edge_idxs[arrival_order[i]]]->trans_type();
+                if(trans == TransitionType::RISE || trans == TransitionType::FALL) {
                     only_static_inputs_applied = false;
                 }
             }
 
-            //At this stage the logic function must have been fully determined
-            assert(f.IsOne() || f.IsZero());
-
             //We now infer from the restricted logic function what the output transition from this node is
             //
             //If only static (i.e. High/Low) inputs were applied we generate a static High/Low output
             //otherwise we produced a dynamic transition (i.e. Rise/Fall)
-            TransitionType output_transition = TransitionType::UNKOWN;
-            if(f.IsOne()) {
+            if(output_one) {
                 if(only_static_inputs_applied) {
                     output_transition = TransitionType::HIGH; 
                 } else {
                     output_transition = TransitionType::RISE; 
                 }
-
-#ifdef VERIFY_TRANSITION
-                //Sanity check that we get and equivalent transition if we evaluate the node function up front
-                auto ref_output_transition = evaluate_output_transition(src_tags, node_func);
-                assert(ref_output_transition == TransitionType::RISE || ref_output_transition == TransitionType::HIGH);
-#endif
             } else {
-                assert(f.IsZero());
-                
                 if(only_static_inputs_applied) {
                     output_transition = TransitionType::LOW; 
                 } else {
                     output_transition = TransitionType::FALL; 
                 }
+            }
+
+            if(use_cache) {
+                TransitionFilterCache::Result result;
+                result.output_transition = output_transition;
+                result.unfiltered_inputs = 0;
+                for(size_t pos = 0; pos < num_data_inputs; ++pos) {
+                    if(input_unfiltered[pos]) {
+                        result.unfiltered_inputs |= (1u << data_edge_idxs[pos]);
+                    }
+                }
+                TransitionFilterCache::insert(*filter_table, cache_key, result);
+            }
+        }
 
 #ifdef VERIFY_TRANSITION
-                //Sanity check that we get and equivalent transition if we evaluate the node function up front
-                auto ref_output_transition = evaluate_output_transition(src_tags, node_func);
+        //Sanity check that we get and equivalent transition if we evaluate the node function up front
+        {
+            std::vector<TransitionType> input_transitions;
+            for(const Tag* tag : src_tags) {
+                input_transitions.push_back(tag->trans_type());
+            }
+            auto ref_output_transition = (use_truth_table) ? evaluate_output_transition(input_transitions, tg.node_truth_table(node_id))
+                                                           : evaluate_output_transition(input_transitions, node_func);
+            if(output_transition == TransitionType::RISE || output_transition == TransitionType::HIGH) {
+                assert(ref_output_transition == TransitionType::RISE || ref_output_transition == TransitionType::HIGH);
+            } else {
                 assert(ref_output_transition == TransitionType::FALL || ref_output_transition == TransitionType::LOW);
-#endif
             }
-            scenario_tag->set_trans_type(output_transition); //Note the actual transition
+        }
+#endif
+
+        //Now that we know what inputs are/are-not filtered compute the arrival time at this node
+        // This is done by taking the worst-case arrival + edge_delay from all unfiltered inputs
+        Time scenario_arr = Time(0.); //Default arrival to avoid nan
+        NodeId scenario_launch_node = -1;
+        for(size_t i = 0; i < num_data_inputs; ++i) {
+            size_t pos = arrival_order[i];
+            if(!input_unfiltered[pos]) continue;
 
-            //Now that we know what inputs are/are-not filtered compute the arrival time at this node
-            // This is done by taking the worst-case arrival + edge_delay from all unfiltered inputs
-            for(auto& unfiltered_input : unfiltered_inputs) {
-                EdgeId edge_id;
-                typename Tag::cptr src_tag;
-                std::tie(edge_id, src_tag) = unfiltered_input;
+            const Tag* src_tag = src_tags[data_edge_idxs[pos]];
 
-                //And update the arrival time to reflect this change
-                Time edge_delay = dc.max_edge_delay(tg, edge_id, src_tag->trans_type(), output_transition);
+            //And update the arrival time to reflect this change
+            Time edge_delay = dc.max_edge_delay(tg, data_edge_ids[pos], src_tag->trans_type(), output_transition);
 
-                Time new_arr = src_tag->arr_time() + edge_delay;
-                assert(!std::isnan(new_arr.value()));
+            Time new_arr = src_tag->arr_time() + edge_delay;
+            assert(!std::isnan(new_arr.value()));
 
-                scenario_tag->max_arr(new_arr, src_tag);
+            if(new_arr.value() > scenario_arr.value() && src_tag->clock_domain() != INVALID_CLOCK_DOMAIN) {
+                scenario_arr = new_arr;
+                scenario_launch_node = src_tag->launch_node();
             }
+        }
+        assert(!std::isnan(scenario_arr.value()));
+
+        //Keep a collection of the input tags used to produce this scenario (for #SAT calculation purposes).
+        //Note that this includes filtered inputs, but not clock inputs
+        for(size_t pos = 0; pos < num_data_inputs; ++pos) {
+            scenario_tag_ids[pos] = src_tags[data_edge_idxs[pos]]->id();
+        }
+        ScenarioId scenario = g_scenario_store.make_leaf(scenario_tag_ids.data(), num_data_inputs);
 
-            scenario_tag->add_input_tags(input_tags); //Save the input tags used to produce this tag
-            
-            //Now we need to merge the scenario into the set of output tags
-            sink_tags.max_arr(scenario_tag); 
+        //Now we need to merge the scenario into the set of output tags
+        merge_scenarios(sink_tags, output_transition, scenario_arr, scenario_launch_node, scenario);
 
 #ifdef TAG_DEBUG
-            std::cout << "\t\toutput: " << output_transition << "@" << scenario_tag->arr_time();
-            if(only_static_inputs_applied) std::cout << " (staticly determined)";
-            std::cout << "\n";
+        std::cout << "\t\toutput: " << output_transition << "@" << scenario_arr;
+        if(cached_result) std::cout << " (cached)";
+        std::cout << "\n";
 #endif
-            assert(!std::isnan(scenario_tag->arr_time().value()));
-            i_case++;
+        i_case++;
+    }
+}
+
+template<class BaseAnalysisMode, class Tags>
+template<class DelayCalcType>
+void ExtSetupAnalysisMode<BaseAnalysisMode,Tags>::evaluate_transition_classes(const TimingGraph& tg, const DelayCalcType& dc, const NodeId node_id, const BDD& node_func, NodeEvalContext& eval_ctx, const std::vector<Tags>& src_data_tag_sets, Tags& sink_tags) {
+    const std::vector<TransitionType> transition_classes = {TransitionType::RISE, TransitionType::FALL, TransitionType::HIGH, TransitionType::LOW};
+
+    //Collect up the data inputs (we skip edges from FF_CLOCK since they never carry data arrivals)
+    //
+    //Note that the tag sets correspond to the node's input edges
+    std::vector<int> data_edge_idxs;
+    for(int edge_idx = 0; edge_idx < tg.num_node_in_edges(node_id); edge_idx++) {
+        NodeId src_node_id = tg.edge_src_node(tg.node_in_edge(node_id, edge_idx));
+        if(tg.node_type(src_node_id) == TN_Type::FF_CLOCK) {
+            continue;
+        }
+        assert(edge_idx < (int) src_data_tag_sets.size());
+        data_edge_idxs.push_back(edge_idx);
+    }
+    const size_t num_data_inputs = data_edge_idxs.size();
+    assert(num_data_inputs > 0);
+
+    //Group each input's tags by transition type
+    std::vector<std::vector<std::vector<const Tag*>>> input_classes(num_data_inputs, std::vector<std::vector<const Tag*>>(transition_classes.size()));
+    std::vector<std::vector<size_t>> input_class_idxs(num_data_inputs); //The non-empty classes of each input
+    for(size_t pos = 0; pos < num_data_inputs; ++pos) {
+        for(const typename Tag::ptr& tag : src_data_tag_sets[data_edge_idxs[pos]]) {
+            auto iter = std::find(transition_classes.begin(), transition_classes.end(), tag->trans_type());
+            assert(iter != transition_classes.end());
+            input_classes[pos][iter - transition_classes.begin()].push_back(tag);
         }
+        for(size_t i_class = 0; i_class < transition_classes.size(); ++i_class) {
+            if(!input_classes[pos][i_class].empty()) {
+                input_class_idxs[pos].push_back(i_class);
+            }
+        }
+        assert(!input_class_idxs[pos].empty());
+    }
 
-#ifdef TAG_DEBUG
-        //The output tags from this node
-        {
-            std::cout << "\tOutput Tags (unreduced):\n";
-            int i_out_tag = 0;
-            for(auto sink_tag : sink_tags) {
-                std::cout << "\t\t" << sink_tag->trans_type() << "@" << sink_tag->arr_time().value() << " cases: " << sink_tag->input_tags().size() << std::endl;
-                i_out_tag++;
+    const bool use_truth_table = tg.node_has_truth_table(node_id);
+
+    //The effective arrival (arrival + edge delay) of an input tag.
+    //Tags without a valid clock domain (e.g. from constant generators) never set the arrival time.
+    typedef std::pair<Time::scalar_type,const Tag*> InputArrival;
+    std::vector<std::vector<InputArrival>> input_arrivals(num_data_inputs);
+
+    std::vector<TransitionType> input_transitions(num_data_inputs);
+    std::vector<char> sensitized(num_data_inputs);
+    std::vector<size_t> class_digits(num_data_inputs, 0);
+    while(true) {
+        for(size_t pos = 0; pos < num_data_inputs; ++pos) {
+            input_transitions[pos] = transition_classes[input_class_idxs[pos][class_digits[pos]]];
+        }
+
+        TransitionType output_transition;
+        if(use_truth_table) {
+            output_transition = evaluate_transition_class(eval_ctx, tg.node_truth_table(node_id), data_edge_idxs, input_transitions, sensitized);
+        } else {
+            output_transition = evaluate_transition_class(eval_ctx, node_func, data_edge_idxs, input_transitions, sensitized);
+        }
+
+        //Sort the sensitized inputs' arrivals, and collect the candidate output arrival times
+        std::vector<Time::scalar_type> output_arrs;
+        for(size_t pos = 0; pos < num_data_inputs; ++pos) {
+            input_arrivals[pos].clear();
+            if(!sensitized[pos]) continue;
+
+            EdgeId edge_id = tg.node_in_edge(node_id, data_edge_idxs[pos]);
+            Time edge_delay = dc.max_edge_delay(tg, edge_id, input_transitions[pos], output_transition);
+            for(const Tag* tag : input_classes[pos][input_class_idxs[pos][class_digits[pos]]]) {
+                Time::scalar_type arr = 0.;
+                if(tag->clock_domain() != INVALID_CLOCK_DOMAIN) {
+                    arr = std::max<Time::scalar_type>(arr, (tag->arr_time() + edge_delay).value());
+                }
+                assert(!std::isnan(arr));
+                input_arrivals[pos].emplace_back(arr, tag);
+                output_arrs.push_back(arr);
             }
+            std::stable_sort(input_arrivals[pos].begin(), input_arrivals[pos].end(),
+                             [](const InputArrival& lhs, const InputArrival& rhs) { return lhs.first < rhs.first; });
         }
-#endif
+        if(output_arrs.empty()) {
+            //No sensitized inputs, any of the input tags produce the output at time zero
+            std::vector<std::vector<TagId>> product(num_data_inputs);
+            for(size_t pos = 0; pos < num_data_inputs; ++pos) {
+                for(const Tag* tag : input_classes[pos][input_class_idxs[pos][class_digits[pos]]]) {
+                    product[pos].push_back(tag->id());
+                }
+            }
+            merge_scenarios(sink_tags, output_transition, Time(0.), -1, g_scenario_store.make_product(product));
+        }
+        std::sort(output_arrs.begin(), output_arrs.end());
+        output_arrs.erase(std::unique(output_arrs.begin(), output_arrs.end()), output_arrs.end());
+
+        //Max-convolution: the output arrives at T when every sensitized input arrives no later than T,
+        //and at least one arrives at T.  These scenarios are split into disjoint products by the first
+        //sensitized input (k) which arrives at T: earlier inputs arrive before T, later inputs no later than T.
+        for(Time::scalar_type output_arr : output_arrs) {
+            for(size_t k = 0; k < num_data_inputs; ++k) {
+                if(!sensitized[k]) continue;
+
+                std::vector<std::vector<TagId>> product(num_data_inputs);
+                NodeId launch_node = -1;
+                bool feasible = true;
+                for(size_t pos = 0; pos < num_data_inputs && feasible; ++pos) {
+                    if(!sensitized[pos]) {
+                        //Any of the input's tags
+                        for(const Tag* tag : input_classes[pos][input_class_idxs[pos][class_digits[pos]]]) {
+                            product[pos].push_back(tag->id());
+                        }
+                        continue;
+                    }
+
+                    for(const InputArrival& input_arr : input_arrivals[pos]) {
+                        if(input_arr.first > output_arr) break; //Sorted, so no later arrivals are included
+
+                        bool include;
+                        if(pos < k) {
+                            include = input_arr.first < output_arr;
+                        } else if(pos == k) {
+                            include = input_arr.first == output_arr;
+                        } else {
+                            include = input_arr.first <= output_arr;
+                        }
+                        if(!include) continue;
+
+                        if(pos == k && product[pos].empty() && input_arr.second->clock_domain() != INVALID_CLOCK_DOMAIN) {
+                            launch_node = input_arr.second->launch_node();
+                        }
+                        product[pos].push_back(input_arr.second->id());
+                    }
+                    feasible = !product[pos].empty();
+                }
+                if(!feasible) continue;
 
-        sink_tags = tag_reducer.merge_tags(node_id, sink_tags);
+                merge_scenarios(sink_tags, output_transition, Time(output_arr), launch_node, g_scenario_store.make_product(product));
+            }
+        }
 
+        //Advance to the next combination of input transitions
+        size_t pos = 0;
+        for(; pos < num_data_inputs; ++pos) {
+            if(++class_digits[pos] < input_class_idxs[pos].size()) break;
+            class_digits[pos] = 0;
+        }
+        if(pos == num_data_inputs) break;
+    }
+}
+
+template<class BaseAnalysisMode, class Tags>
+void ExtSetupAnalysisMode<BaseAnalysisMode,Tags>::merge_scenarios(Tags& sink_tags, TransitionType output_transition, const Time& scenario_arr, NodeId launch_node, ScenarioId scenarios) {
+    const DomainId scenario_domain = 0; //Currently only single-clock supported
+    auto iter = sink_tags.find_matching_tag(scenario_domain, output_transition, scenario_arr);
+    if(iter == sink_tags.end()) {
+        auto scenario_tag = Tag::make_ptr(scenario_arr, Time(NAN), scenario_domain, launch_node, output_transition);
+        scenario_tag->add_scenarios(scenarios);
+        sink_tags.add_tag(scenario_tag);
+    } else {
+        sink_tags.max_arr(iter, scenario_arr, launch_node, scenarios);
+    }
+}
+
+template<class BaseAnalysisMode, class Tags>
+template<class Func>
+TransitionType ExtSetupAnalysisMode<BaseAnalysisMode,Tags>::evaluate_transition_class(const NodeEvalContext& eval_ctx, const Func& f, const std::vector<int>& data_edge_idxs, const std::vector<TransitionType>& input_transitions, std::vector<char>& sensitized) {
+    //The function's final value, and the function after applying the static inputs
+    Func f_final = f;
+    Func f_static = f;
+    for(size_t pos = 0; pos < input_transitions.size(); ++pos) {
+        int var_idx = data_edge_idxs[pos];
+        TransitionType trans = input_transitions[pos];
+
+        if(trans != TransitionType::RISE && trans != TransitionType::FALL) {
+            f_static = apply_restriction(eval_ctx.cudd, var_idx, trans, f_static);
+        }
+        f_final = apply_restriction(eval_ctx.cudd, var_idx, trans, f_final);
+    }
+    assert(is_constant(f_final));
+
+    bool dynamic_input_sensitized = false;
+    for(size_t pos = 0; pos < input_transitions.size(); ++pos) {
+        int var_idx = data_edge_idxs[pos];
+        TransitionType trans = input_transitions[pos];
+
+        bool dynamic = (trans == TransitionType::RISE || trans == TransitionType::FALL);
+        const Func& f_dep = (dynamic) ? f_static : f;
+        sensitized[pos] = apply_restriction(eval_ctx.cudd, var_idx, TransitionType::HIGH, f_dep)
+                          != apply_restriction(eval_ctx.cudd, var_idx, TransitionType::LOW, f_dep);
+
+        if(dynamic && sensitized[pos]) {
+            dynamic_input_sensitized = true;
+        }
+    }
+
+    //Like the permutation evaluation, the output is a dynamic transition (to its final value) if a dynamic
+    //input was sensitized, even if the initial value was the same (e.g. AND(Rise,Fall) glitches, so is a Fall)
+    if(is_one(f_final)) {
+        return (dynamic_input_sensitized) ? TransitionType::RISE : TransitionType::HIGH;
+    } else {
+        return (dynamic_input_sensitized) ? TransitionType::FALL : TransitionType::LOW;
+    }
+}
+
+template<class BaseAnalysisMode, class Tags>
+template<class Func>
+size_t ExtSetupAnalysisMode<BaseAnalysisMode,Tags>::apply_input_transitions(const NodeEvalContext& eval_ctx, const std::vector<const Tag*>& src_tags, const std::vector<int>& data_edge_idxs, const std::vector<size_t>& arrival_order, size_t first_input, std::vector<Func>& applied_funcs, std::vector<char>& unfiltered) {
+    size_t i_input = first_input;
+    for(; i_input < arrival_order.size(); ++i_input) {
+        const Func& f = applied_funcs[i_input];
+
+        //Check if the function has already been determined.
+        //If it has we don't need to look at any more inputs
+        if(is_constant(f)) {
+            break;
+        }
+
+        int edge_idx = data_edge_idxs[arrival_order[i_input]];
+        const Tag* src_tag = src_tags[edge_idx];
+
+        //We now apply this inputs transition to restrict the logic function
+        applied_funcs[i_input+1] = apply_restriction(eval_ctx.cudd, edge_idx, src_tag->trans_type(), f);
+
+        //If the variable had no effect on the logic output we do not need to consider its
+        //delay impact
+        unfiltered[i_input] = (applied_funcs[i_input+1] != f);
 #ifdef TAG_DEBUG
-        //The output tags from this node
-        {
-            std::cout << "\tOutput Tags (reduced):\n";
-            int i_out_tag = 0;
-            for(auto sink_tag : sink_tags) {
-                std::cout << "\t\t" << sink_tag->trans_type() << "@" << sink_tag->arr_time().value() << " cases: " << sink_tag->input_tags().size() << std::endl;
-                i_out_tag++;
-            }
+        if(!unfiltered[i_input]) {
+            std::cout << "\t\tFiltered: input " << edge_idx << std::endl;
         }
 #endif
     }
+
+    //At this stage the logic function must have been fully determined
+    assert(is_constant(applied_funcs[i_input]));
+
+    return i_input;
+}
+
+template<class BaseAnalysisMode, class Tags>
+void ExtSetupAnalysisMode<BaseAnalysisMode,Tags>::merge_partial_tags(const NodeId node_id, const std::vector<Tags>& partial_tag_sets) {
+    Tags& sink_tags = setup_data_tags_[node_id];
+
+    //The partial sets are merged in order, so the resulting tags (and the order of their
+    //scenarios) are the same as if all permutations were evaluated into sink_tags directly
+    for(const Tags& partial_tags : partial_tag_sets) {
+        for(const typename Tag::ptr& tag : partial_tags) {
+            auto iter = sink_tags.find_matching_tag(tag);
+            if(iter == sink_tags.end()) {
+                //The partial tags are not shared, so we can take them directly
+                sink_tags.add_tag(tag);
+            } else {
+                sink_tags.max_arr(iter, tag);
+            }
+        }
+    }
 }
 
 template<class BaseAnalysisMode, class Tags>
-BDD ExtSetupAnalysisMode<BaseAnalysisMode,Tags>::apply_restriction(int var_idx, TransitionType input_trans, BDD f) {
+BDD ExtSetupAnalysisMode<BaseAnalysisMode,Tags>::apply_restriction(const Cudd& cudd, int var_idx, TransitionType input_trans, BDD f) {
     //We store the node functions using variables 0..num_inputs-1
-    //Get the resulting BDD variable
-    BDD var = g_cudd.bddVar(var_idx);
+    //Get the resulting BDD variable (from the manager which owns f)
+    BDD var = cudd.bddVar(var_idx);
 
     //FALL/LOW transitions result in logically false values, so we need to invert
     //the raw variable (which is non-inverted)
@@ -437,7 +909,7 @@ void ExtSetupAnalysisMode<BaseAnalysisMode,Tags>::gen_tag_permutations_recurr(co
 }
 
 template<class BaseAnalysisMode, class Tags>
-TagPermutationGenerator ExtSetupAnalysisMode<BaseAnalysisMode,Tags>::reduce_permutations(const TimingGraph& tg, NodeId node_id, std::vector<Tags> src_data_tag_sets, size_t max_permutations, double delay_bin_size_scale_fac, const TagReducer& tag_reducer) {
+TagPermutationGenerator ExtSetupAnalysisMode<BaseAnalysisMode,Tags>::reduce_permutations(const TimingGraph& tg, NodeId node_id, std::vector<Tags> src_data_tag_sets, size_t max_permutations, double delay_bin_size_scale_fac, const TagReducer& tag_reducer, std::ostream& log) {
     //This function returns a TagPermutationGenerator used to drive the main analysis loop for a 
     //single node
     //
@@ -450,74 +922,165 @@ TagPermutationGenerator ExtSetupAnalysisMode<BaseAnalysisMode,Tags>::reduce_perm
     //To handle this we 'reduce' the input tags to keep the number of permutations below a specified
     //threshold (max_permutations)
     //
-    //We 'reduce' the tags on a particular input by re-merging them at increasing delay bin sizes.
-    // 
-    //We always reduce the input with the most tags. This ensures we loose resolution somewhat uniformally,
-    //avoiding the loss of all resolution on a particular input.
+    //We 'reduce' the tags on a particular input by re-merging them at a larger delay bin size.
+    //The bin size of each input is chosen by plan_input_bin_sizes(), and each input is then
+    //re-merged (at most) once.
 
+    double num_permutations = 1.;
+    for(const Tags& tags : src_data_tag_sets) {
+        num_permutations *= tags.num_tags();
+    }
+
+    if(num_permutations > max_permutations && max_permutations != 0) {
+        log << "Node " << node_id << "(bin_size=" << tag_reducer.default_bin_size() << "): Orig Perms " << num_permutations << std::endl;
+
+        std::vector<double> input_bin_sizes = plan_input_bin_sizes(tg, node_id, src_data_tag_sets, max_permutations, delay_bin_size_scale_fac, tag_reducer);
 
-    //Create the tag permutation generator from the given set of tags
-    TagPermutationGenerator tag_permutation_generator(src_data_tag_sets);
+        num_permutations = 1.;
+        for(size_t i = 0; i < src_data_tag_sets.size(); ++i) {
+            if(input_bin_sizes[i] != 0.) {
+                //Reduce the tags on this input
+                // We must be careful to pass in the input's source node ID, so that we use the correct required
+                // time (since these are input, not output tags) when slack binning
+                EdgeId edge_id = tg.node_in_edge(node_id, i);
+                NodeId src_node_id = tg.edge_src_node(edge_id);
 
-    //Initialize scaling factors
-    std::vector<double> input_scale_factors(src_data_tag_sets.size(), delay_bin_size_scale_fac);
+                //Merging modifies the merged tags, so merge copies (the originals are shared with the source node)
+                Tags input_tags;
+                for(typename Tag::cptr tag : src_data_tag_sets[i]) {
+                    input_tags.add_tag(Tag::make_ptr(*tag));
+                }
+                src_data_tag_sets[i] = tag_reducer.merge_tags(src_node_id, input_tags, input_bin_sizes[i]);
 
-    size_t num_permutations = tag_permutation_generator.num_permutations();
+                log << "Node " << node_id;
+                log << " reduced tags on input " << i;
+                log << " (new_bin_size=" << input_bin_sizes[i];
+                log << ", tags=" << src_data_tag_sets[i].num_tags() << ")" << std::endl;
+            }
+            num_permutations *= src_data_tag_sets[i].num_tags();
+        }
 
-    auto max_tag_delay = 0.f;
-    for(const auto& tags : src_data_tag_sets) {
-        for(const auto& tag : tags) {
-            max_tag_delay = std::max(max_tag_delay, tag->arr_time().value());
+        log << "Node " << node_id << " Reduced Perms " << num_permutations;
+        if(num_permutations > max_permutations) {
+            log << " (inputs can not be reduced further)";
         }
+        log << std::endl;
     }
 
-    if(num_permutations > max_permutations && max_permutations != 0) {
-        std::cout << "Node " << node_id << "(bin_size=" << tag_reducer.default_bin_size() << "): Orig Perms " << num_permutations << std::endl;
+    return TagPermutationGenerator(src_data_tag_sets);
+}
 
-        //Iteratively reduce the number of tags (by increasing the delay bin size an input causeing tags to merge)
-        while(num_permutations > max_permutations) {
+template<class BaseAnalysisMode, class Tags>
+std::vector<double> ExtSetupAnalysisMode<BaseAnalysisMode,Tags>::plan_input_bin_sizes(const TimingGraph& tg, NodeId node_id, const std::vector<Tags>& src_data_tag_sets, size_t max_permutations, double delay_bin_size_scale_fac, const TagReducer& tag_reducer) {
+    //Each input's candidate bin sizes grow geometrically (by delay_bin_size_scale_fac) from the
+    //reducer's default bin size.  Moving an input to a larger bin size reduces the number of
+    //permutations (by the ratio of its tag counts) at the cost of adding up to the increase in
+    //bin size of delay error (pessimism) on that input.
+    //
+    //We greedily take the step (across all inputs) with the largest reduction per unit of delay
+    //error (using a priority queue), until we are below max_permutations.  Since the number of
+    //permutations is the product of the tag counts, the reduction is measured as the log of the
+    //ratio of tag counts.
+    //
+    //An input is exhausted once its bin size exceeds its maximum tag delay (since larger bins
+    //can not merge any more tags); we then continue reducing the remaining inputs.
+    const size_t num_inputs = src_data_tag_sets.size();
+
+    struct InputState {
+        NodeId src_node_id;
+        double max_tag_delay;
+        size_t level; //Number of times the bin size has been scaled (0 is un-reduced)
+        double bin_size; //0 if un-reduced
+        size_t num_tags;
+    };
+
+    struct Reduction {
+        double priority; //Log reduction in permutations per unit of delay error
+        size_t input;
+        size_t level;
+        double bin_size;
+        size_t num_tags;
+
+        bool operator<(const Reduction& other) const {
+            //Prefer lower input indicies on ties, so the plan is deterministic
+            return std::tie(priority, other.input) < std::tie(other.priority, input);
+        }
+    };
+
+    double max_tag_delay = 0.;
+    std::vector<InputState> inputs(num_inputs);
+    for(size_t i = 0; i < num_inputs; ++i) {
+        EdgeId edge_id = tg.node_in_edge(node_id, i);
+        inputs[i].src_node_id = tg.edge_src_node(edge_id);
+
+        inputs[i].max_tag_delay = 0.;
+        for(typename Tag::cptr tag : src_data_tag_sets[i]) {
+            if(tag->arr_time().valid()) {
+                inputs[i].max_tag_delay = std::max<double>(inputs[i].max_tag_delay, tag->arr_time().value());
+            }
+        }
+        max_tag_delay = std::max(max_tag_delay, inputs[i].max_tag_delay);
 
-            //Find the element with the most tags
-            auto cmp = [](const Tags& lhs, const Tags& rhs) {
-                return lhs.num_tags() < rhs.num_tags();
-            };
-            auto iter = std::max_element(src_data_tag_sets.begin(), src_data_tag_sets.end(), cmp);
+        inputs[i].level = 0;
+        inputs[i].bin_size = 0.;
+        inputs[i].num_tags = src_data_tag_sets[i].num_tags();
+    }
+
+    //If the reducer performs no binning by default, start from a small fraction of the maximum delay
+    double base_bin_size = tag_reducer.default_bin_size();
+    if(base_bin_size <= 0.) {
+        base_bin_size = MIN_PLANNER_BIN_SIZE_FRAC * max_tag_delay;
+    }
 
-            //Get it's index
-            size_t i = iter - src_data_tag_sets.begin();
+    //Finds the next bin size which reduces the input's tags, returns false if there is none
+    auto find_next_reduction = [&](size_t i, Reduction& reduction) {
+        const InputState& input = inputs[i];
+        if(input.num_tags <= 1 || base_bin_size <= 0.) return false;
 
-            //Increase the bin size
-            double new_bin_size = tag_reducer.default_bin_size() * input_scale_factors[i];
+        double bin_size = input.bin_size;
+        for(size_t level = input.level + 1; bin_size <= input.max_tag_delay; ++level) {
+            bin_size = base_bin_size * std::pow(delay_bin_size_scale_fac, level);
 
-            //If the bin size is larger than the maximum tag delay we will not get any more reductions, so give up
-            //TODO: we could handle this more intelligently by moving to another input (which might be reducable), for now leave as future work
-            if(new_bin_size > max_tag_delay) {
-                std::cout << "Bin size " << new_bin_size << " exceeded maximum tag delay " << max_tag_delay << " giving up on limiting permutations" << "\n";
-                break;
+            size_t num_tags = tag_reducer.num_merged_tags(input.src_node_id, src_data_tag_sets[i], bin_size);
+            if(num_tags < input.num_tags) {
+                double delay_error = bin_size - input.bin_size;
+                reduction = {std::log(double(input.num_tags) / num_tags) / delay_error, i, level, bin_size, num_tags};
+                return true;
             }
+        }
+        return false;
+    };
 
-            //Reduce the tags on this input
-            // We must be careful to pass in the input's source node ID, so that we use the correct required
-            // time (since these are input, not output tags) when slack binning
-            EdgeId edge_id = tg.node_in_edge(node_id, i);
-            NodeId src_node_id = tg.edge_src_node(edge_id);
-            src_data_tag_sets[i] = tag_reducer.merge_tags(src_node_id, src_data_tag_sets[i], new_bin_size);
+    double num_permutations = 1.;
+    std::priority_queue<Reduction> reductions;
+    for(size_t i = 0; i < num_inputs; ++i) {
+        num_permutations *= inputs[i].num_tags;
 
-            //Increase the scale factor (for the next time we reduce this input)
-            input_scale_factors[i] *= delay_bin_size_scale_fac;
+        Reduction reduction;
+        if(find_next_reduction(i, reduction)) {
+            reductions.push(reduction);
+        }
+    }
 
-            //Create the new generator
-            tag_permutation_generator = TagPermutationGenerator(src_data_tag_sets);
+    while(num_permutations > max_permutations && !reductions.empty()) {
+        Reduction reduction = reductions.top();
+        reductions.pop();
 
-            std::cout << "Node " << node_id;
-            std::cout << " reduced tags on input " << i;
-            std::cout << " (new_bin_size=" << new_bin_size;
-            std::cout << ", tags=" << src_data_tag_sets[i].num_tags() << "):";
-            std::cout << " Perms " << tag_permutation_generator.num_permutations() << std::endl;
+        InputState& input = inputs[reduction.input];
+        num_permutations = num_permutations / input.num_tags * reduction.num_tags;
+        input.level = reduction.level;
+        input.bin_size = reduction.bin_size;
+        input.num_tags = reduction.num_tags;
 
-            num_permutations = tag_permutation_generator.num_permutations();
-        } 
+        Reduction next_reduction;
+        if(find_next_reduction(reduction.input, next_reduction)) {
+            reductions.push(next_reduction);
+        }
     }
 
-    return tag_permutation_generator;
+    std::vector<double> input_bin_sizes(num_inputs);
+    for(size_t i = 0; i < num_inputs; ++i) {
+        input_bin_sizes[i] = inputs[i].bin_size;
+    }
+    return input_bin_sizes;
 }
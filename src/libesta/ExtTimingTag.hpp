@@ -6,9 +6,8 @@
 #include <memory>
 #include <unordered_map>
 
-#include <boost/intrusive_ptr.hpp>
-
 #include "bdd.hpp"
+#include "ScenarioStore.hpp"
 #include "Time.hpp"
 #include "TransitionType.hpp"
 #include "timing_graph_fwd.hpp"
@@ -31,16 +30,24 @@
 
 class ExtTimingTag {
     public:
-        typedef boost::intrusive_ptr<ExtTimingTag> ptr; //Mutable pointer
-        typedef boost::intrusive_ptr<const ExtTimingTag> cptr; //Immutable pointer
+        //Tags are owned by g_scenario_store, so pointers to them are plain (non-owning) pointers
+        typedef ExtTimingTag* ptr; //Mutable pointer
+        typedef const ExtTimingTag* cptr; //Immutable pointer
 
-        //Class method for constructing a dynamically allocated ExtTimingTag and returning
-        //a boost::intrusive_ptr to it.
+        //Class method for constructing an ExtTimingTag in g_scenario_store and returning
+        //a pointer to it.
         //Any provided arguments are passed to the constructor.
         //
-        //Use this instead of manually 'new'ing the tag yourself
+        //Use this instead of manually 'new'ing the tag yourself.
+        //The tag remains valid until g_scenario_store is cleared (i.e. the analysis is reset)
         template<typename ... ARGS>
-        static ptr make_ptr(ARGS&&... args) { return new ExtTimingTag(std::forward<ARGS>(args)...); }
+        static ptr make_ptr(ARGS&&... args) {
+            TagId id = g_scenario_store.allocate_tag();
+            ptr tag = g_scenario_store.tag(id);
+            *tag = ExtTimingTag(std::forward<ARGS>(args)...);
+            tag->id_ = id;
+            return tag;
+        }
 
         /*
          * Constructors
@@ -78,7 +85,17 @@ class ExtTimingTag {
         ///\returns This tag's associated transition type
         TransitionType trans_type() const { return trans_type_; }
 
-        const std::vector<std::vector<ExtTimingTag::cptr>>& input_tags() const { return input_tags_; }
+        ///\returns This tag's id in g_scenario_store
+        TagId id() const { return id_; }
+
+        ///\returns The switching scenarios (i.e. input tags) which generate this tag, stored in g_scenario_store
+        ScenarioId scenarios() const { return scenarios_; }
+
+        ///\returns The number of (possibly factored) switching scenarios which generate this tag
+        size_t num_scenarios() const { return g_scenario_store.num_scenarios(scenarios_); }
+
+        ///\returns true if the tag has no switching scenarios (i.e. it was launched from a primary input)
+        bool is_launch_tag() const { return scenarios_ == INVALID_SCENARIO_ID; }
 
         /*
          * Setters
@@ -98,7 +115,8 @@ class ExtTimingTag {
         ///\param new_trans The new value to set as the tag's transition type
         void set_trans_type(const TransitionType& new_trans_type) { trans_type_ = new_trans_type; }
 
-        void add_input_tags(const std::vector<ExtTimingTag::cptr>& t) { input_tags_.push_back(t); }
+        ///Adds the scenarios (stored in g_scenario_store) to those which generate this tag
+        void add_scenarios(ScenarioId new_scenarios) { scenarios_ = g_scenario_store.make_union(scenarios_, new_scenarios); }
 
         /*
          * Modification operations
@@ -138,6 +156,9 @@ class ExtTimingTag {
         ///\returns true if the meta-data of the current and other tag match
         bool matches(ExtTimingTag::cptr other) const;
 
+        ///\returns true if a tag with the specified meta-data would match the current tag
+        bool matches(DomainId domain, TransitionType trans, const Time& arr) const;
+
     private:
         void update_arr(const Time new_arr, ExtTimingTag::cptr& base_tag);
         //void update_req(const Time& new_req_time, const ExtTimingTag& base_tag);
@@ -145,26 +166,13 @@ class ExtTimingTag {
         /*
          * Data
          */
-        std::vector<std::vector<ExtTimingTag::cptr>> input_tags_;
+        ScenarioId scenarios_ = INVALID_SCENARIO_ID; //Scenarios which generate this tag
+        TagId id_ = INVALID_TAG_ID;
         NodeId launch_node_; //Node which launched this arrival time
         DomainId clock_domain_; //Clock domain for arr/req times
         TransitionType trans_type_; //The transition type associated with this tag
         Time arr_time_; //Arrival time
         //Time req_time_; //Required time
-
-
-        //Reference counting for boost intrusive_ptr
-        mutable int ref_cnt_ = 0;
-        friend inline void intrusive_ptr_add_ref(const ExtTimingTag* tag) {
-            assert(tag->ref_cnt_ < std::numeric_limits<int>::max());
-            ++(tag->ref_cnt_);
-        }
-
-        friend inline void intrusive_ptr_release(const ExtTimingTag* tag) {
-            if(--(tag->ref_cnt_) == 0) {
-                delete tag;
-            }
-        }
 };
 
 std::ostream& operator<<(std::ostream& os, const ExtTimingTag& tag);
@@ -193,6 +201,9 @@ inline ExtTimingTag::ExtTimingTag(const Time& arr_time_val, const Time& req_time
     //, req_time_(req_time_val)
     {}
 
+inline ExtTimingTag* ScenarioStore::tag(TagId id) { return &tags_[id]; }
+inline const ExtTimingTag* ScenarioStore::tag(TagId id) const { return &tags_[id]; }
+
 inline void ExtTimingTag::update_arr(const Time new_arr, ExtTimingTag::cptr& base_tag) {
     if(base_tag->clock_domain() != INVALID_CLOCK_DOMAIN) {
         assert(clock_domain() == base_tag->clock_domain()); //Domain must be the same
@@ -213,18 +224,24 @@ inline void ExtTimingTag::max_arr(const Time new_arr, ExtTimingTag::cptr& base_t
 inline bool ExtTimingTag::matches(ExtTimingTag::cptr other) const {
     //If a tag 'matches' it is typically collapsed into the matching tag.
 
-    bool match = (clock_domain() == other->clock_domain());
+    bool match = matches(other->clock_domain(), other->trans_type(), other->arr_time());
 
-#ifdef TAG_MATCH_TRANSITION
-    match &= (trans_type() == other->trans_type() || trans_type() == TransitionType::MAX);
+#ifdef TAG_MATCH_SWITCH_FUNC
+    match &= (switch_func() == other->switch_func());
 #endif
 
-#ifdef TAG_MATCH_DELAY
-    match &= (arr_time() == other->arr_time());
+    return match;
+}
+
+inline bool ExtTimingTag::matches(DomainId domain, TransitionType trans, const Time& arr) const {
+    bool match = (clock_domain() == domain);
+
+#ifdef TAG_MATCH_TRANSITION
+    match &= (trans_type() == trans || trans_type() == TransitionType::MAX);
 #endif
 
-#ifdef TAG_MATCH_SWITCH_FUNC
-    match &= (switch_func() == other->switch_func());
+#ifdef TAG_MATCH_DELAY
+    match &= (arr_time() == arr);
 #endif
 
     return match;
@@ -239,19 +256,20 @@ inline std::ostream& operator<<(std::ostream& os, const ExtTimingTag& tag) {
     //os << "Req: " << tag.req_time().value() << " ";
 
 #ifdef DEBUG_TAG_PRINT
-    if(tag.input_tags().size() > 0) {
+    g_scenario_store.for_each_scenario(tag.scenarios(), [&](const ScenarioStore::Scenario& scenario) {
         os << "\n";
         os << "\t\t";
-        for(auto scenario : tag.input_tags()) {
-            for(auto in_tag : scenario) {
+        for(size_t i = 0; i < scenario.num_inputs(); ++i) {
+            if(scenario.num_alternatives(i) == 1) {
+                const ExtTimingTag* in_tag = scenario.alternative_tag(i, 0);
                 os << "  " << in_tag;
-                os << " Trans: " << in_tag->trans_type();  
-                os << " Arr:   " << in_tag->arr_time().value();  
+                os << " Trans: " << in_tag->trans_type();
+                os << " Arr:   " << in_tag->arr_time().value();
+            } else {
+                os << "  {" << scenario.num_alternatives(i) << " tags}";
             }
-            os << "\n";
-            os << "\t\t";
         }
-    }
+    });
     //os << "\t\t";
 #endif
 
@@ -1,12 +1,41 @@
 #pragma once
 #include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 #include "ExtTimingTag.hpp"
 
+//Number of tags compared (branch-free) at a time by ExtTimingTags::find_matching_tag()
+const size_t TAG_MATCH_BLOCK_SIZE = 16;
+
+//Number of tags above which ExtTimingTags maintains a hash index for matching
+//(smaller sets are faster to scan)
+const size_t TAG_INDEX_MIN_TAGS = 32;
+
+/*
+ * A set of ExtTimingTags.
+ *
+ * The tag fields used for matching (arrival time, transition type and clock domain) are
+ * mirrored in contiguous arrays (structure-of-arrays), so find_matching_tag() scans them with
+ * vectorizable compares rather than dereferencing each tag.  The tags themselves (which hold
+ * the launch node and switching scenarios needed to build BDDs) are only touched once a match
+ * is found.
+ *
+ * Larger sets also maintain a hash index from the matching fields to the first tag with those
+ * values, so finding (and hence merging into) a matching tag is O(1) expected.
+ *
+ * Since the arrays and index mirror the tags, a tag's matching fields must only be modified
+ * through this class (e.g. max_arr()) once it has been added to the set.
+ */
 class ExtTimingTags {
     public:
         typedef ExtTimingTag Tag;
-        typedef std::vector<Tag::ptr>::iterator iterator;
+        //Iterators can not re-order the set (which would invalidate the arrays), use sort() instead
+        typedef std::vector<Tag::ptr>::const_iterator iterator;
         typedef std::vector<Tag::ptr>::const_iterator const_iterator;
 
         /*
@@ -18,15 +47,16 @@ class ExtTimingTags {
         ///Finds a TimingTag in the current set that has clock domain id matching domain_id
         ///\param base_tag The tag to match meta-data against
         ///\returns An iterator to the tag if found, or end() if not found
-        iterator find_matching_tag(Tag::cptr base_tag);
-        const_iterator find_matching_tag(Tag::cptr base_Tag) const;
+        const_iterator find_matching_tag(Tag::cptr base_tag) const;
+
+        ///Finds a TimingTag in the current set which matches the specified meta-data
+        ///\returns An iterator to the tag if found, or end() if not found
+        const_iterator find_matching_tag(DomainId domain, TransitionType trans, const Time& arr) const;
 
         ///\returns An iterator to the first tag in the current set
-        iterator begin() { return tags_.begin(); }
         const_iterator begin() const { return tags_.begin(); }
 
         ///\returns An iterator 'one-past-the-end' of the current set
-        iterator end() { return tags_.end(); }
         const_iterator end() const { return tags_.end(); }
 
         /*
@@ -36,6 +66,16 @@ class ExtTimingTags {
         ///\param src_tag The source tag who is inserted. Note that the src_tag is copied when inserted (the original is unchanged)
         iterator add_tag(Tag::ptr src_tag);
 
+        ///Replaces a tag with an equivalent tag (i.e. one with the same matching fields)
+        ///\param iter The tag to replace
+        ///\param tag The replacement tag
+        void replace_tag(iterator iter, Tag::ptr tag);
+
+        ///Sorts the tags in the current set
+        ///\param compare A strict weak ordering on Tag::cptr
+        template<class Compare>
+        void sort(Compare compare);
+
         /*
          * Setup operations
          */
@@ -46,6 +86,13 @@ class ExtTimingTags {
         void max_arr(Tag::cptr base_tag);
         void max_arr(iterator merge_tag_iter, Tag::cptr base_tag);
 
+        ///Merges switching scenarios into an existing tag
+        ///\param merge_tag_iter The tag to merge into
+        ///\param arr The scenarios' arrival time
+        ///\param launch_node The scenarios' launch node
+        ///\param scenarios The scenarios (stored in g_scenario_store)
+        void max_arr(iterator merge_tag_iter, const Time& arr, NodeId launch_node, ScenarioId scenarios);
+
         ///Updates the required time of this set of tags to be the minimum.
         ///\param new_time The new arrival time to compare against
         ///\param base_tag The associated metat-data for new_time
@@ -55,11 +102,61 @@ class ExtTimingTags {
         ///Clears the tags in the current set
         void clear();
 
-    protected:
+    private:
+        //The matching fields of a tag, as used by the index (the full fields are kept, so tags with
+        //different fields never share a key)
+        struct MatchKey {
+            DomainId domain;
+            TransitionType trans;
+            uint32_t arr_bits; //Bit pattern of the (normalized) arrival time
+
+            bool operator==(const MatchKey& other) const {
+                return domain == other.domain && trans == other.trans && arr_bits == other.arr_bits;
+            }
+        };
+
+        struct MatchKeyHash {
+            size_t operator()(const MatchKey& key) const {
+                size_t hash = std::hash<DomainId>()(key.domain);
+                hash = hash * 31 + std::hash<int>()(static_cast<int>(key.trans));
+                hash = hash * 31 + std::hash<uint32_t>()(key.arr_bits);
+                return hash;
+            }
+        };
+
+        size_t index(const_iterator iter) const { return iter - tags_.begin(); }
+
+        //Re-loads the matching fields of the tag at idx
+        void load_fields(size_t idx);
+
+        //Updates the arrival time of the tag at idx (re-indexing it if required)
+        void update_arr_value(size_t idx, Time::scalar_type arr_value);
+
+        const_iterator scan_matching_tag(DomainId domain, TransitionType trans, Time::scalar_type arr_value) const;
+        const_iterator lookup_matching_tag(DomainId domain, TransitionType trans, Time::scalar_type arr_value) const;
+
+        //Returns true if the tag at idx matches the specified fields (as in scan_matching_tag())
+        bool tag_matches(size_t idx, DomainId domain, TransitionType trans, Time::scalar_type arr_value) const;
+
+        //The index key for the matching fields
+        static MatchKey match_key(DomainId domain, TransitionType trans, Time::scalar_type arr_value);
+        MatchKey match_key(size_t idx) const { return match_key(clock_domains_[idx], trans_types_[idx], arr_values_[idx]); }
 
+        bool indexed() const { return tags_.size() > TAG_INDEX_MIN_TAGS; }
+        void index_tag(size_t idx);
+        void unindex_tag(size_t idx);
+        void rebuild_index();
 
     private:
         std::vector<Tag::ptr> tags_;
+
+        //Matching fields of each tag, indexed as tags_
+        std::vector<Time::scalar_type> arr_values_;
+        std::vector<TransitionType> trans_types_;
+        std::vector<DomainId> clock_domains_;
+
+        //Index of the first tag with each (valid) match key, only maintained if indexed()
+        std::unordered_map<MatchKey,uint32_t,MatchKeyHash> index_;
 };
 
 /*
@@ -75,10 +172,37 @@ inline ExtTimingTags::iterator ExtTimingTags::add_tag(Tag::ptr tag) {
     //}
 
     tags_.push_back(tag);
+    arr_values_.push_back(tag->arr_time().value());
+    trans_types_.push_back(tag->trans_type());
+    clock_domains_.push_back(tag->clock_domain());
+
+    if(tags_.size() == TAG_INDEX_MIN_TAGS + 1) {
+        rebuild_index(); //Large enough to be worth indexing
+    } else if(indexed()) {
+        index_tag(tags_.size() - 1);
+    }
 
     return tags_.end() - 1;
 }
 
+inline void ExtTimingTags::replace_tag(iterator iter, Tag::ptr tag) {
+    size_t idx = index(iter);
+    assert(match_key(tag->clock_domain(), tag->trans_type(), tag->arr_time().value()) == match_key(idx));
+
+    tags_[idx] = tag;
+}
+
+template<class Compare>
+void ExtTimingTags::sort(Compare compare) {
+    std::sort(tags_.begin(), tags_.end(), compare);
+    for(size_t i = 0; i < tags_.size(); ++i) {
+        load_fields(i);
+    }
+    if(indexed()) {
+        rebuild_index();
+    }
+}
+
 inline void ExtTimingTags::max_arr(Tag::cptr tag) {
     auto iter = find_matching_tag(tag);
 
@@ -96,31 +220,181 @@ inline void ExtTimingTags::max_arr(iterator merge_tag_iter, Tag::cptr tag) {
     Tag::ptr matched_tag = *merge_tag_iter;
     
     matched_tag->max_arr(tag->arr_time(), tag);
+    update_arr_value(index(merge_tag_iter), matched_tag->arr_time().value());
 
     //'tag' has been merged, with 'merge_tag_iter', so we need to update 
     //'merge_tag_iter's switching scenarios (i.e. input tags that generate
-    //the tag)
-    for(auto& scenario : tag->input_tags()) {
-        matched_tag->add_input_tags(scenario);
-    }
+    //the tag).  The scenarios are referenced, not copied
+    matched_tag->add_scenarios(tag->scenarios());
 }
 
+inline void ExtTimingTags::max_arr(iterator merge_tag_iter, const Time& arr, NodeId launch_node, ScenarioId scenarios) {
+    assert(merge_tag_iter != end());
+
+    const Tag::ptr& matched_tag = *merge_tag_iter;
+
+    if(!matched_tag->arr_time().valid() || arr.value() > matched_tag->arr_time().value()) {
+        matched_tag->set_arr_time(arr);
+        matched_tag->set_launch_node(launch_node);
+        update_arr_value(index(merge_tag_iter), arr.value());
+    }
+
+    matched_tag->add_scenarios(scenarios);
+}
 
 inline void ExtTimingTags::clear() {
-    //TODO: handle memory leaks...
+    //Note: the tags themselves are owned (and released) by g_scenario_store
     tags_.clear();
+    arr_values_.clear();
+    trans_types_.clear();
+    clock_domains_.clear();
+    index_.clear();
 }
 
-inline ExtTimingTags::iterator ExtTimingTags::find_matching_tag(Tag::cptr base_tag) {
-    auto pred = [&](Tag::cptr tag) {
-        return tag->matches(base_tag);
-    };
-    return std::find_if(begin(), end(), pred);
+inline void ExtTimingTags::load_fields(size_t idx) {
+    arr_values_[idx] = tags_[idx]->arr_time().value();
+    trans_types_[idx] = tags_[idx]->trans_type();
+    clock_domains_[idx] = tags_[idx]->clock_domain();
 }
 
 inline ExtTimingTags::const_iterator ExtTimingTags::find_matching_tag(Tag::cptr base_tag) const {
-    auto pred = [&](Tag::cptr tag) {
-        return tag->matches(base_tag);
-    };
-    return std::find_if(begin(), end(), pred);
+    //Equivalent to Tag::matches()
+    return find_matching_tag(base_tag->clock_domain(), base_tag->trans_type(), base_tag->arr_time());
+}
+
+inline void ExtTimingTags::update_arr_value(size_t idx, Time::scalar_type arr_value) {
+    if(arr_values_[idx] == arr_value) return;
+
+    if(indexed()) unindex_tag(idx);
+    arr_values_[idx] = arr_value;
+    if(indexed()) index_tag(idx);
+}
+
+inline ExtTimingTags::const_iterator ExtTimingTags::find_matching_tag(DomainId domain, TransitionType trans, const Time& arr) const {
+    if(indexed()) {
+        return lookup_matching_tag(domain, trans, arr.value());
+    } else {
+        return scan_matching_tag(domain, trans, arr.value());
+    }
+}
+
+inline ExtTimingTags::const_iterator ExtTimingTags::scan_matching_tag(DomainId domain, TransitionType trans, Time::scalar_type arr_value) const {
+    const Time::scalar_type* arr_values = arr_values_.data();
+    const TransitionType* trans_types = trans_types_.data();
+    const DomainId* clock_domains = clock_domains_.data();
+
+    //Build a bit-mask of the matches in each block of tags. The inner loop is
+    //branch-free so it can be vectorized; we only branch once per block
+    const size_t ntags = tags_.size();
+    for(size_t block_begin = 0; block_begin < ntags; block_begin += TAG_MATCH_BLOCK_SIZE) {
+        const size_t block_size = std::min(TAG_MATCH_BLOCK_SIZE, ntags - block_begin);
+
+        uint32_t match_mask = 0;
+        for(size_t i = 0; i < block_size; ++i) {
+            const size_t idx = block_begin + i;
+
+            bool match = (clock_domains[idx] == domain);
+#ifdef TAG_MATCH_TRANSITION
+            match &= (trans_types[idx] == trans) | (trans_types[idx] == TransitionType::MAX);
+#endif
+#ifdef TAG_MATCH_DELAY
+            match &= (arr_values[idx] == arr_value);
+#endif
+            match_mask |= uint32_t(match) << i;
+        }
+
+        if(match_mask) {
+            //The first match
+            return tags_.begin() + block_begin + __builtin_ctz(match_mask);
+        }
+    }
+    return end();
+}
+
+inline ExtTimingTags::const_iterator ExtTimingTags::lookup_matching_tag(DomainId domain, TransitionType trans, Time::scalar_type arr_value) const {
+#ifdef TAG_MATCH_DELAY
+    if(std::isnan(arr_value)) return end(); //NaN arrival times never compare equal
+#endif
+
+    //The first tag with exactly the same fields
+    size_t match_idx = tags_.size();
+    auto iter = index_.find(match_key(domain, trans, arr_value));
+    if(iter != index_.end() && tag_matches(iter->second, domain, trans, arr_value)) {
+        match_idx = iter->second;
+    }
+
+#ifdef TAG_MATCH_TRANSITION
+    //MAX tags match any transition, so the first match may be a MAX tag instead
+    if(trans != TransitionType::MAX) {
+        iter = index_.find(match_key(domain, TransitionType::MAX, arr_value));
+        if(iter != index_.end() && tag_matches(iter->second, domain, trans, arr_value)) {
+            match_idx = std::min<size_t>(match_idx, iter->second);
+        }
+    }
+#endif
+
+    return tags_.begin() + match_idx;
+}
+
+inline bool ExtTimingTags::tag_matches(size_t idx, DomainId domain, TransitionType trans, Time::scalar_type arr_value) const {
+    bool match = (clock_domains_[idx] == domain);
+#ifdef TAG_MATCH_TRANSITION
+    match &= (trans_types_[idx] == trans) | (trans_types_[idx] == TransitionType::MAX);
+#else
+    (void) trans;
+#endif
+#ifdef TAG_MATCH_DELAY
+    match &= (arr_values_[idx] == arr_value);
+#else
+    (void) arr_value;
+#endif
+    return match;
+}
+
+inline ExtTimingTags::MatchKey ExtTimingTags::match_key(DomainId domain, TransitionType trans, Time::scalar_type arr_value) {
+    MatchKey key = {domain, TransitionType::UNKOWN, 0};
+#ifdef TAG_MATCH_TRANSITION
+    key.trans = trans;
+#endif
+#ifdef TAG_MATCH_DELAY
+    static_assert(sizeof(Time::scalar_type) == sizeof(uint32_t), "Arrival time must fit in 32-bits");
+    arr_value += 0.; //Normalize -0. to 0., since they compare equal
+    std::memcpy(&key.arr_bits, &arr_value, sizeof(key.arr_bits));
+#else
+    (void) arr_value;
+#endif
+    return key;
+}
+
+inline void ExtTimingTags::index_tag(size_t idx) {
+#ifdef TAG_MATCH_DELAY
+    if(std::isnan(arr_values_[idx])) return; //Can never match
+#endif
+    //Keep the first tag with each key
+    auto result = index_.emplace(match_key(idx), idx);
+    if(!result.second && result.first->second > idx) {
+        result.first->second = idx;
+    }
+}
+
+inline void ExtTimingTags::unindex_tag(size_t idx) {
+    MatchKey key = match_key(idx);
+    auto iter = index_.find(key);
+    if(iter == index_.end() || iter->second != idx) return; //Not the first tag with this key
+
+    //Fall back to the next tag with the same key (if any)
+    index_.erase(iter);
+    for(size_t i = idx + 1; i < tags_.size(); ++i) {
+        if(match_key(i) == key) {
+            index_.emplace(key, i);
+            break;
+        }
+    }
+}
+
+inline void ExtTimingTags::rebuild_index() {
+    index_.clear();
+    for(size_t i = 0; i < tags_.size(); ++i) {
+        index_tag(i);
+    }
 }
@@ -0,0 +1,31 @@
+#pragma once
+#include <vector>
+
+#include "SerialTimingAnalyzer.hpp"
+#include "ExtSetupAnalysisMode.hpp"
+
+/*
+ * The IncrementalEstaTimingAnalyzer is a SerialTimingAnalyzer which can also incrementally
+ * update the ESTA tags after the delays of some edges are changed (in the delay calculator,
+ * see PreCalcTransDelayCalculator::set_max_edge_delay()).
+ *
+ * update_timing() re-evaluates only the fanout cone of the modified edges, rather than the whole
+ * graph.  Nodes are re-evaluated in level order; if a re-evaluated node's tags are unchanged
+ * (see ExtSetupAnalysisMode::revalidate_node()) its fanout is not re-evaluated.
+ *
+ * The tags replaced by the update are reported by replaced_tags(), so any results derived from
+ * them (e.g. xfuncs cached by a SharpSatEvaluator) can be invalidated.
+ */
+template<class AnalysisType, class DelayCalcType>
+class IncrementalEstaTimingAnalyzer : public SerialTimingAnalyzer<AnalysisType, DelayCalcType> {
+    public:
+        IncrementalEstaTimingAnalyzer(const TimingGraph& timing_graph, const TimingConstraints& timing_constraints, const DelayCalcType& delay_calculator, const TagReducer& tag_reducer, size_t max_permutations=0);
+
+        ///Incrementally updates the (forward) timing after edge delays have changed.
+        ///calculate_timing() must have been called previously.
+        /// \param modified_edges The edges whose delays have changed
+        void update_timing(const std::vector<EdgeId>& modified_edges);
+};
+
+//Implementation
+#include "IncrementalEstaTimingAnalyzer.tpp"
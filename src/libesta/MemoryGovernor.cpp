@@ -0,0 +1,165 @@
+#include <algorithm>
+#include <cassert>
+#include <iomanip>
+#include <iostream>
+
+#include <sys/resource.h>
+
+#include "cuddInt.h"
+
+#include "bdd.hpp"
+#include "MemoryGovernor.hpp"
+#include "ScenarioStore.hpp"
+#include "ExtTimingTag.hpp"
+
+MemoryGovernor g_memory_governor;
+
+//How the limit is divided (as fractions of the limit)
+const double CUDD_MEMORY_FRAC = 0.75; //CUDD's hard limit (the rest is left for tags/scenarios and other data)
+const double CUDD_CACHE_FRAC = 0.10; //CUDD's computed table (part of CUDD's share)
+const double BDD_CACHE_FRAC = 0.25; //Nodes retained by caches of BDDs (part of CUDD's share)
+
+//Memory pressure is relieved once usage exceeds this fraction of the limit
+const double PRESSURE_FRAC = 0.85;
+
+//After relieving pressure, it is only relieved again once usage has grown by this fraction of the limit
+const double PRESSURE_HYSTERESIS_FRAC = 0.05;
+
+static size_t max_rss_bytes();
+
+MemoryGovernor::MemoryGovernor()
+    : limit_(0)
+    , pressure_threshold_(0)
+    , next_handler_id_(0)
+    , num_pressure_events_(0)
+    , in_phase_(false) {}
+
+void MemoryGovernor::set_limit(size_t limit_bytes) {
+    limit_ = limit_bytes;
+    pressure_threshold_ = PRESSURE_FRAC * limit_;
+}
+
+void MemoryGovernor::configure_cudd(Cudd& cudd, size_t num_shares) const {
+    if(limit_ == 0) return;
+
+    size_t share = limit_ / std::max<size_t>(num_shares, 1);
+    size_t max_memory = CUDD_MEMORY_FRAC * share;
+
+    cudd.SetMaxMemory(max_memory);
+    cudd.SetMaxCacheHard(CUDD_CACHE_FRAC * share / sizeof(DdCache));
+
+    //The unique table otherwise grows (without garbage collecting) based on the memory available
+    //when the manager was created, rather than its maximum memory
+    cudd.SetLooseUpTo(max_memory / (sizeof(DdNode) * DD_MAX_LOOSE_FRACTION));
+}
+
+void MemoryGovernor::add_cudd(const Cudd& cudd) {
+    cudds_.push_back(&cudd);
+}
+
+void MemoryGovernor::remove_cudd(const Cudd& cudd) {
+    cudds_.erase(std::remove(cudds_.begin(), cudds_.end(), &cudd), cudds_.end());
+}
+
+void MemoryGovernor::split_limit(size_t num_shares) {
+    if(limit_ == 0 || num_shares <= 1) return;
+
+    size_t usage = memory_in_use();
+    if(usage < limit_) {
+        set_limit(usage + (limit_ - usage) / num_shares);
+    }
+}
+
+size_t MemoryGovernor::bdd_cache_node_budget() const {
+    return BDD_CACHE_FRAC * limit_ / sizeof(DdNode);
+}
+
+size_t MemoryGovernor::add_pressure_handler(std::function<void()> handler) {
+    size_t id = next_handler_id_++;
+    pressure_handlers_[id] = handler;
+    return id;
+}
+
+void MemoryGovernor::remove_pressure_handler(size_t id) {
+    pressure_handlers_.erase(id);
+}
+
+size_t MemoryGovernor::memory_in_use() const {
+    size_t usage = g_cudd.ReadMemoryInUse() + g_scenario_store.memory_used();
+    for(const Cudd* cudd : cudds_) {
+        usage += cudd->ReadMemoryInUse();
+    }
+    return usage;
+}
+
+void MemoryGovernor::check() {
+    size_t usage = memory_in_use();
+    sample(usage);
+
+    if(limit_ > 0 && usage > pressure_threshold_) {
+        relieve_pressure();
+
+        size_t relieved_usage = memory_in_use();
+        pressure_threshold_ = std::max<size_t>(PRESSURE_FRAC * limit_, relieved_usage + PRESSURE_HYSTERESIS_FRAC * limit_);
+
+        std::cout << "Memory pressure: " << usage / (1024*1024) << " MiB in use, "
+                  << relieved_usage / (1024*1024) << " MiB after relief"
+                  << " (limit " << limit_ / (1024*1024) << " MiB)" << std::endl;
+    }
+}
+
+void MemoryGovernor::begin_phase(const std::string& name) {
+    end_phase();
+
+    phases_.push_back({name, 0, 0});
+    in_phase_ = true;
+    sample(memory_in_use());
+}
+
+void MemoryGovernor::end_phase() {
+    if(!in_phase_) return;
+
+    sample(memory_in_use());
+    phases_.back().max_rss = max_rss_bytes();
+    in_phase_ = false;
+}
+
+void MemoryGovernor::print_report(std::ostream& os) const {
+    auto old_precision = os.precision();
+    os << "Peak Memory Usage (MiB):\n";
+    os << "\t" << std::setw(24) << std::left << "Phase" << std::right << " " << std::setw(10) << "CUDD+Tags" << " " << std::setw(10) << "Max RSS" << "\n";
+    for(const PhaseStats& phase : phases_) {
+        os << "\t" << std::setw(24) << std::left << phase.name << std::right;
+        os << " " << std::setw(10) << std::fixed << std::setprecision(1) << phase.peak_usage / (1024.*1024.);
+        os << " " << std::setw(10) << std::fixed << std::setprecision(1) << phase.max_rss / (1024.*1024.) << "\n";
+    }
+    os.unsetf(std::ios_base::floatfield);
+    os.precision(old_precision);
+    if(limit_ > 0) {
+        os << "\tLimit: " << limit_ / (1024*1024) << " MiB, Pressure Events: " << num_pressure_events_ << "\n";
+    }
+}
+
+void MemoryGovernor::relieve_pressure() {
+    ++num_pressure_events_;
+
+    for(auto& kv : pressure_handlers_) {
+        kv.second();
+    }
+
+    //Reclaim the nodes released by the handlers
+    cuddGarbageCollect(g_cudd.getManager(), 1);
+}
+
+void MemoryGovernor::sample(size_t usage) {
+    if(!in_phase_) return;
+
+    phases_.back().peak_usage = std::max(phases_.back().peak_usage, usage);
+}
+
+static size_t max_rss_bytes() {
+    rusage usage;
+    if(getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+
+    return size_t(usage.ru_maxrss) * 1024; //ru_maxrss is in KiB on linux
+}
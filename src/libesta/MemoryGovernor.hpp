@@ -0,0 +1,106 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "cuddObj.hh"
+
+/*
+ * Keeps the analysis within a memory budget.
+ *
+ * The limit is split between CUDD (its hard memory limit and computed table size), the
+ * caches of BDDs built by the analysis (as a budget of BDD nodes), and the tags/scenarios
+ * (which are not bounded, but are counted towards the usage).
+ *
+ * Additional managers (e.g. those of parallel worker threads) are each limited to a share of
+ * the CUDD budget, and are counted towards the usage while registered (see add_cudd()).
+ * Forked processes each restrict themselves to a share of the remaining budget (see split_limit()).
+ *
+ * The analysis periodically calls check(), which samples the memory in use and, once it
+ * approaches the limit, relieves the pressure by asking the registered caches to evict
+ * entries and then garbage collecting the freed BDD nodes.
+ *
+ * The peak usage is tracked for each phase of the analysis (see begin_phase()).
+ *
+ * With no limit set, check() only tracks the peak usage.
+ */
+class MemoryGovernor {
+    public:
+        MemoryGovernor();
+
+        ///Sets the memory limit
+        ///\param limit_bytes The limit in bytes (zero implies no limit)
+        void set_limit(size_t limit_bytes);
+        size_t limit() const { return limit_; }
+
+        ///Applies the limit to a CUDD manager's maximum memory, unique table growth and computed table (cache) size
+        ///\param num_shares The number of managers sharing the limit, each of which is limited to an equal share
+        void configure_cudd(Cudd& cudd, size_t num_shares=1) const;
+
+        ///Counts the memory used by an additional manager (e.g. a worker thread's) until it is removed
+        void add_cudd(const Cudd& cudd);
+        void remove_cudd(const Cudd& cudd);
+
+        ///Restricts the limit to one of num_shares equal shares of the remaining budget, e.g. in each of
+        ///several forked processes. The memory already in use is inherited by all of them, so only the
+        ///budget beyond it is split.
+        void split_limit(size_t num_shares);
+
+        ///\returns The number of BDD nodes which caches of BDDs (e.g. xfuncs) may retain (zero implies no limit)
+        size_t bdd_cache_node_budget() const;
+
+        ///Registers a handler which is called to release memory (e.g. evict cached BDDs) when usage nears the limit
+        ///\returns An id which can be used to remove the handler
+        size_t add_pressure_handler(std::function<void()> handler);
+        void remove_pressure_handler(size_t id);
+
+        ///\returns The estimated memory currently in use by the CUDD managers and the tags/scenarios in bytes
+        size_t memory_in_use() const;
+
+        ///Samples the memory in use, relieving memory pressure if it is near the limit.
+        ///Must only be called while no BDD operations are in progress on the global manager.
+        void check();
+
+        ///Starts tracking the peak memory usage of the named phase (ending any current phase)
+        void begin_phase(const std::string& name);
+
+        ///Ends tracking of the current phase
+        void end_phase();
+
+        ///Prints the peak memory usage of each phase
+        void print_report(std::ostream& os) const;
+
+    private:
+        //Calls the pressure handlers and garbage collects
+        void relieve_pressure();
+
+        //Updates the peak usage of the current phase
+        void sample(size_t usage);
+
+    private:
+        size_t limit_;
+
+        //Pressure is only relieved again once the usage reaches this threshold, to avoid
+        //repeatedly (and uselessly) garbage collecting when most memory is live
+        size_t pressure_threshold_;
+
+        std::vector<const Cudd*> cudds_; //Additional managers (besides g_cudd)
+
+        std::map<size_t,std::function<void()>> pressure_handlers_;
+        size_t next_handler_id_;
+        size_t num_pressure_events_;
+
+        struct PhaseStats {
+            std::string name;
+            size_t peak_usage;
+            size_t max_rss; //Of the whole process at the end of the phase
+        };
+        std::vector<PhaseStats> phases_;
+        bool in_phase_;
+};
+
+//The global memory governor, for the global CUDD manager
+extern MemoryGovernor g_memory_governor;
@@ -0,0 +1,19 @@
+#pragma once
+#include <iostream>
+
+#include "bdd.hpp"
+#include "TransitionFilterCache.hpp"
+
+//The state used while evaluating nodes during the ESTA forward traversal.
+//
+//None of this state is thread-safe, so each thread evaluating nodes concurrently
+//must use its own context (and BDD manager).
+struct NodeEvalContext {
+    NodeEvalContext(const Cudd& cudd_mgr)
+        : cudd(cudd_mgr)
+        , log(&std::cout) {}
+
+    const Cudd& cudd; //The manager which owns the node functions
+    TransitionFilterCache filter_cache; //Cached transition/filter results for each node function
+    std::ostream* log; //Where progress messages are written (worker threads buffer them, see ParallelEstaTimingAnalyzer)
+};
@@ -0,0 +1,85 @@
+#pragma once
+#include <memory>
+#include <vector>
+
+#include "bdd.hpp"
+#include "SerialTimingAnalyzer.hpp"
+#include "ExtSetupAnalysisMode.hpp"
+#include "TagPermutationGenerator.hpp"
+
+/*
+ * The ParallelEstaTimingAnalyzer performs the ESTA forward traversal using multiple threads.
+ *
+ * Like the SerialTimingAnalyzer the timing graph is walked level-by-level, with each level
+ * fully evaluated before the next is started.  Within a level the nodes are independent
+ * (they only read the tags of upstream nodes and write their own tags) and are distributed
+ * dynamically across a pool of worker threads.
+ *
+ * CUDD managers are not thread-safe, so each worker owns its own manager holding a copy of
+ * every node function (transferred from g_cudd before the traversal starts).  All BDD operations
+ * performed while evaluating a node (e.g. restricting the node function) use the worker's manager.
+ *
+ * Since each node is evaluated completely by a single worker, in the same way as the serial
+ * analyzer, the resulting tags are identical to those produced by the SerialTimingAnalyzer.
+ *
+ * Narrow levels (a single node) are evaluated serially on the calling thread, where the thread
+ * start-up overhead would outweigh any potential speed-up.
+ *
+ * A few nodes with very high fan-in can have many orders of magnitude more input tag permutations
+ * than the rest of their level, and would otherwise serialize the traversal behind them.  Such 'wide'
+ * nodes are instead evaluated one at a time using all workers: the node's permutation index space
+ * is split into contiguous chunks which are evaluated independently into partial tag sets, and the
+ * partial sets are merged in chunk order (so the resulting tags are again identical to the serial
+ * analyzer's).  This only applies to NodeEvalMode::PERMUTATION, since the cost of the other modes
+ * does not grow with the number of permutations.
+ */
+template<class AnalysisType, class DelayCalcType>
+class ParallelEstaTimingAnalyzer : public SerialTimingAnalyzer<AnalysisType, DelayCalcType> {
+    public:
+        ///\param num_workers The number of worker threads to use during the forward traversal
+        ParallelEstaTimingAnalyzer(const TimingGraph& timing_graph, const TimingConstraints& timing_constraints, const DelayCalcType& delay_calculator, const TagReducer& tag_reducer, size_t max_permutations, size_t num_workers);
+
+        ///\param val The number of input tag permutations beyond which a node's permutations are evaluated in parallel
+        void set_wide_node_threshold(size_t val) { wide_node_threshold_ = val; }
+
+    protected:
+        //Per-thread BDD state
+        struct Worker {
+            std::unique_ptr<Cudd> cudd; //The worker's private manager
+            std::vector<BDD> node_funcs; //Node functions owned by cudd [0..timing_graph.num_nodes()-1]
+            std::unique_ptr<NodeEvalContext> eval_ctx; //Evaluation context (caches) using cudd
+        };
+
+        void forward_traversal() override;
+
+        ///Creates the worker managers and transfers the node functions into them
+        void initialize_workers();
+
+        ///Destroys the worker managers
+        void release_workers();
+
+        ///Evaluates the specified nodes using the worker pool (one node per worker at a time)
+        void forward_traverse_nodes_parallel(const std::vector<NodeId>& nodes);
+
+        ///Evaluates a single node by splitting its permutations across the worker pool
+        void forward_traverse_wide_node(const NodeId node_id);
+
+        ///\returns The number of input tag permutations at node_id (before any reduction)
+        double estimate_permutations(const NodeId node_id) const;
+
+        ///Runs func(worker_idx) on num_threads workers (the calling thread acts as worker 0)
+        template<class Func>
+        void run_workers(size_t num_threads, Func func);
+
+        ///Per node worker function for the forward traversal, using the worker's manager
+        /// \param node_id The node to process
+        /// \param worker The worker state to use
+        void forward_traverse_node(const NodeId node_id, Worker& worker);
+
+        size_t num_workers_;
+        size_t wide_node_threshold_;
+        std::vector<Worker> workers_;
+};
+
+//Implementation
+#include "ParallelEstaTimingAnalyzer.tpp"
@@ -0,0 +1,244 @@
+#include <atomic>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+
+#include "MemoryGovernor.hpp"
+
+//By default nodes with more input tag permutations than this are evaluated
+//using all workers
+const size_t DEFAULT_WIDE_NODE_THRESHOLD = 100000;
+
+//The number of chunks each worker evaluates (on average) for a wide node.
+//Using more chunks than workers balances the load, since the evaluation cost
+//varies across the permutation space
+const size_t WIDE_NODE_CHUNKS_PER_WORKER = 8;
+
+template<class AnalysisType, class DelayCalcType>
+ParallelEstaTimingAnalyzer<AnalysisType,DelayCalcType>::ParallelEstaTimingAnalyzer(const TimingGraph& tg, const TimingConstraints& tc, const DelayCalcType& dc, const TagReducer& tag_reducer, size_t max_permutations, size_t num_workers)
+    : SerialTimingAnalyzer<AnalysisType,DelayCalcType>(tg, tc, dc, tag_reducer, max_permutations)
+    , num_workers_(std::max<size_t>(num_workers, 1))
+    , wide_node_threshold_(DEFAULT_WIDE_NODE_THRESHOLD) {
+}
+
+template<class AnalysisType, class DelayCalcType>
+void ParallelEstaTimingAnalyzer<AnalysisType,DelayCalcType>::forward_traversal() {
+    using namespace std::chrono;
+
+    initialize_workers();
+
+    //Forward traversal (arrival times)
+    for(LevelId level_id = this->first_fwd_level_; level_id < this->tg_.num_levels(); level_id++) {
+        auto fwd_level_start = high_resolution_clock::now();
+
+        const auto& level = this->tg_.level(level_id);
+
+        std::cout << "\tLevel " << level_id << " (" << level.size() << " nodes)" << std::endl;
+
+        //Split out the nodes which are too expensive to be evaluated by a single worker
+        std::vector<NodeId> narrow_nodes;
+        std::vector<NodeId> wide_nodes;
+        for(NodeId node_id : level) {
+            if(num_workers_ > 1 && this->node_eval_mode() == NodeEvalMode::PERMUTATION
+               && estimate_permutations(node_id) > wide_node_threshold_) {
+                wide_nodes.push_back(node_id);
+            } else {
+                narrow_nodes.push_back(node_id);
+            }
+        }
+
+        if(narrow_nodes.size() >= 2 && num_workers_ > 1) {
+            forward_traverse_nodes_parallel(narrow_nodes);
+        } else {
+            //Serial, using the global manager
+            for(NodeId node_id : narrow_nodes) {
+                SerialTimingAnalyzer<AnalysisType,DelayCalcType>::forward_traverse_node(node_id);
+            }
+        }
+
+        for(NodeId node_id : wide_nodes) {
+            forward_traverse_wide_node(node_id);
+        }
+
+        this->print_level_stats(level_id);
+
+        //The workers are idle between levels
+        g_memory_governor.check();
+
+        if(this->level_callback_) {
+            this->level_callback_(level_id);
+        }
+
+        auto fwd_level_end = high_resolution_clock::now();
+        std::string key = std::string("fwd_level_") + std::to_string(level_id);
+        this->perf_data_[key] = duration_cast<duration<double>>(fwd_level_end - fwd_level_start).count();
+    }
+
+    release_workers();
+}
+
+template<class AnalysisType, class DelayCalcType>
+void ParallelEstaTimingAnalyzer<AnalysisType,DelayCalcType>::initialize_workers() {
+    release_workers();
+
+    workers_.resize(num_workers_);
+    for(Worker& worker : workers_) {
+        worker.cudd = std::unique_ptr<Cudd>(new Cudd(g_cudd.ReadSize()));
+
+        //The workers split the memory budget, and count towards the usage
+        g_memory_governor.configure_cudd(*worker.cudd, num_workers_);
+        g_memory_governor.add_cudd(*worker.cudd);
+        worker.node_funcs.resize(this->tg_.num_nodes());
+
+        //Many nodes share the same logic function (e.g. buffers), so only transfer
+        //each distinct function once
+        std::unordered_map<BDD,BDD> transferred_funcs;
+        for(NodeId node_id = 0; node_id < this->tg_.num_nodes(); node_id++) {
+            BDD node_func = this->tg_.node_func(node_id);
+
+            auto iter = transferred_funcs.find(node_func);
+            if(iter == transferred_funcs.end()) {
+                BDD worker_func = node_func.Transfer(*worker.cudd);
+                iter = transferred_funcs.insert(std::make_pair(node_func, worker_func)).first;
+            }
+            worker.node_funcs[node_id] = iter->second;
+        }
+
+        worker.eval_ctx = std::unique_ptr<NodeEvalContext>(new NodeEvalContext(*worker.cudd));
+    }
+}
+
+template<class AnalysisType, class DelayCalcType>
+void ParallelEstaTimingAnalyzer<AnalysisType,DelayCalcType>::release_workers() {
+    for(Worker& worker : workers_) {
+        //Free the BDDs before their manager
+        worker.eval_ctx.reset();
+        worker.node_funcs.clear();
+        if(worker.cudd) {
+            g_memory_governor.remove_cudd(*worker.cudd);
+        }
+        worker.cudd.reset();
+    }
+    workers_.clear();
+}
+
+template<class AnalysisType, class DelayCalcType>
+template<class Func>
+void ParallelEstaTimingAnalyzer<AnalysisType,DelayCalcType>::run_workers(size_t num_threads, Func func) {
+    assert(num_threads <= workers_.size());
+
+    std::vector<std::thread> threads;
+    for(size_t i = 1; i < num_threads; ++i) {
+        threads.emplace_back(func, i);
+    }
+
+    //The calling thread acts as the first worker
+    func(0);
+
+    for(auto& thread : threads) {
+        thread.join();
+    }
+}
+
+template<class AnalysisType, class DelayCalcType>
+void ParallelEstaTimingAnalyzer<AnalysisType,DelayCalcType>::forward_traverse_nodes_parallel(const std::vector<NodeId>& nodes) {
+    //Nodes are handed out dynamically since the evaluation time of each node
+    //varies greatly (it depends on the number of input tag permutations)
+    std::atomic<size_t> next_node_idx(0);
+
+    //Workers buffer each node's progress messages, which are printed (in node order)
+    //by the calling thread once the level is complete, so they do not interleave
+    std::vector<std::string> node_logs(nodes.size());
+
+    auto worker_func = [&](size_t worker_idx) {
+        Worker& worker = workers_[worker_idx];
+        for(size_t node_idx = next_node_idx++; node_idx < nodes.size(); node_idx = next_node_idx++) {
+            std::ostringstream node_log;
+            worker.eval_ctx->log = &node_log;
+
+            forward_traverse_node(nodes[node_idx], worker);
+
+            node_logs[node_idx] = node_log.str();
+        }
+        worker.eval_ctx->log = &std::cout;
+    };
+
+    run_workers(std::min(num_workers_, nodes.size()), worker_func);
+
+    for(const std::string& node_log : node_logs) {
+        std::cout << node_log;
+    }
+    std::cout.flush();
+}
+
+template<class AnalysisType, class DelayCalcType>
+void ParallelEstaTimingAnalyzer<AnalysisType,DelayCalcType>::forward_traverse_wide_node(const NodeId node_id) {
+    //Pull from upstream sources to current node
+    for(int edge_idx = 0; edge_idx < this->tg_.num_node_in_edges(node_id); edge_idx++) {
+        EdgeId edge_id = this->tg_.node_in_edge(node_id, edge_idx);
+
+        AnalysisType::forward_traverse_edge(this->tg_, this->tc_, this->dc_, node_id, edge_id);
+    }
+
+    auto src_data_tag_sets = AnalysisType::forward_traverse_input_tags(this->tg_, this->dc_, node_id);
+    if(src_data_tag_sets.empty()) {
+        return;
+    }
+
+    auto tag_permutation_generator = AnalysisType::reduce_permutations(this->tg_, node_id, src_data_tag_sets, this->max_permutations_, DELAY_BIN_SIZE_SCALE_FAC, this->tag_reducer_, std::cout);
+
+    size_t num_permutations = tag_permutation_generator.num_permutations();
+    size_t num_chunks = std::max<size_t>(1, std::min(num_permutations, num_workers_*WIDE_NODE_CHUNKS_PER_WORKER));
+
+    std::cout << "\tNode " << node_id << " evaluating " << num_permutations << " permutations in " << num_chunks << " chunks" << std::endl;
+
+    //Each chunk is evaluated into its own tag set
+    std::vector<typename AnalysisType::TagSet> partial_tag_sets(num_chunks);
+
+    std::atomic<size_t> next_chunk_idx(0);
+    auto worker_func = [&](size_t worker_idx) {
+        Worker& worker = workers_[worker_idx];
+        for(size_t chunk_idx = next_chunk_idx++; chunk_idx < num_chunks; chunk_idx = next_chunk_idx++) {
+            TagPermutationGenerator chunk_generator = tag_permutation_generator;
+            chunk_generator.set_range((chunk_idx * num_permutations) / num_chunks, ((chunk_idx + 1) * num_permutations) / num_chunks);
+
+            AnalysisType::evaluate_permutations(this->tg_, this->dc_, node_id, worker.node_funcs[node_id], *worker.eval_ctx,
+                                                chunk_generator, partial_tag_sets[chunk_idx]);
+        }
+    };
+
+    run_workers(std::min(num_workers_, num_chunks), worker_func);
+
+    //Merge the partial results (in chunk order) and reduce as usual
+    AnalysisType::merge_partial_tags(node_id, partial_tag_sets);
+
+    this->setup_data_tags_[node_id] = this->tag_reducer_.merge_tags(node_id, this->setup_data_tags_[node_id]);
+}
+
+template<class AnalysisType, class DelayCalcType>
+double ParallelEstaTimingAnalyzer<AnalysisType,DelayCalcType>::estimate_permutations(const NodeId node_id) const {
+    double node_perms = 1.;
+    for(int edge_idx = 0; edge_idx < this->tg_.num_node_in_edges(node_id); edge_idx++) {
+        EdgeId edge_id = this->tg_.node_in_edge(node_id, edge_idx);
+        NodeId src_node_id = this->tg_.edge_src_node(edge_id);
+
+        size_t num_src_tags = this->setup_data_tags(src_node_id).num_tags();
+        if(num_src_tags != 0) {
+            node_perms *= num_src_tags;
+        }
+    }
+    return node_perms;
+}
+
+template<class AnalysisType, class DelayCalcType>
+void ParallelEstaTimingAnalyzer<AnalysisType,DelayCalcType>::forward_traverse_node(const NodeId node_id, Worker& worker) {
+    //Pull from upstream sources to current node
+    for(int edge_idx = 0; edge_idx < this->tg_.num_node_in_edges(node_id); edge_idx++) {
+        EdgeId edge_id = this->tg_.node_in_edge(node_id, edge_idx);
+
+        AnalysisType::forward_traverse_edge(this->tg_, this->tc_, this->dc_, node_id, edge_id);
+    }
+
+    AnalysisType::forward_traverse_finalize_node(this->tg_, this->tc_, this->dc_, node_id, this->tag_reducer_, this->max_permutations_,
+                                                 worker.node_funcs[node_id], *worker.eval_ctx);
+}
@@ -36,6 +36,15 @@ class PreCalcTransDelayCalculator {
             return delay;
         }
 
+        ///Updates the delay of an edge (e.g. for incremental re-analysis)
+        ///\param edge_id The edge to update
+        ///\param output_trans The output transition whose delay is updated
+        ///\param delay The new delay
+        ///\see IncrementalEstaTimingAnalyzer::update_timing()
+        void set_max_edge_delay(EdgeId edge_id, TransitionType output_trans, const Time& delay) {
+            edge_delays_[edge_id][output_trans] = delay;
+        }
+
 
     private:
         EdgeDelayModel edge_delays_;
@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <iostream>
+
+#include "cuddInt.h"
+#include "util.h" //From CUDD
+
+#include "bdd.hpp"
+#include "ReorderScheduler.hpp"
+
+ReorderScheduler g_reorder_scheduler;
+
+//A reordering is productive if it removes at least this fraction of the nodes
+const double MIN_PRODUCTIVE_REDUCTION = 0.10;
+
+//Consecutive unproductive passes before switching to a cheaper method
+const size_t MAX_UNPRODUCTIVE_PASSES = 2;
+
+//The next threshold's growth factor after a productive pass (CUDD's default), and the
+//most it backs off to
+const double BASE_GROWTH = 2.;
+const double MAX_GROWTH = 64.;
+
+//The smallest next threshold
+const long MIN_NEXT_REORDER = 4096;
+
+ReorderScheduler::ReorderScheduler()
+    : max_time_frac_(1.)
+    , start_time_ms_(0)
+    , method_idx_(0)
+    , paused_(false)
+    , growth_(BASE_GROWTH)
+    , num_unproductive_(0)
+    , nodes_before_(0)
+    , num_reorders_(0)
+    , num_productive_(0)
+    , num_over_budget_(0)
+    , nodes_removed_(0) {}
+
+void ReorderScheduler::configure(Cudd& cudd, Cudd_ReorderingType method, double max_time_frac) {
+    max_time_frac_ = max_time_frac;
+    start_time_ms_ = util_cpu_time();
+
+    methods_.clear();
+    method_idx_ = 0;
+    paused_ = false;
+    if(method == CUDD_REORDER_NONE) {
+        cudd.AutodynDisable();
+        return;
+    }
+
+    //Fall back to plain sifting, and then to window permutation (which is much cheaper, but
+    //only makes local improvements)
+    methods_.push_back(method);
+    bool is_window = (method >= CUDD_REORDER_WINDOW2 && method <= CUDD_REORDER_WINDOW4_CONV);
+    if(method != CUDD_REORDER_SIFT && !is_window) {
+        methods_.push_back(CUDD_REORDER_SIFT);
+    }
+    if(!is_window) {
+        methods_.push_back(CUDD_REORDER_WINDOW3);
+    }
+
+    cudd.AutodynEnable(method);
+}
+
+void ReorderScheduler::begin_reorder(DdManager* dd) {
+    nodes_before_ = Cudd_ReadNodeCount(dd);
+}
+
+void ReorderScheduler::end_reorder(DdManager* dd, unsigned long reorder_time_ms) {
+    long nodes_after = Cudd_ReadNodeCount(dd);
+
+    ++num_reorders_;
+    nodes_removed_ += nodes_before_ - nodes_after;
+
+    //Check the budget first, so a productive pass can not undo the back-off
+    bool over_budget = !within_budget(dd);
+    if(over_budget) {
+        ++num_over_budget_;
+        back_off();
+    }
+
+    double reduction = (nodes_before_ > 0) ? 1. - (double) nodes_after / nodes_before_ : 0.;
+    if(reduction >= MIN_PRODUCTIVE_REDUCTION) {
+        ++num_productive_;
+        num_unproductive_ = 0;
+        if(!over_budget) {
+            growth_ = BASE_GROWTH;
+        }
+    } else {
+        ++num_unproductive_;
+        back_off();
+
+        if(num_unproductive_ >= MAX_UNPRODUCTIVE_PASSES) {
+            next_method(dd);
+        }
+    }
+
+    //Hold off further reordering until the rest of the analysis catches up (see check_budget())
+    if(over_budget && has_method()) {
+        paused_ = true;
+        Cudd_AutodynDisable(dd);
+    }
+
+    if(enabled()) {
+        long next_reorder = std::max((long) (growth_ * nodes_after), MIN_NEXT_REORDER) + dd->constants.keys;
+        Cudd_SetNextReordering(dd, next_reorder);
+    }
+}
+
+void ReorderScheduler::check_budget(DdManager* dd) {
+    if(!paused_ || !within_budget(dd)) return;
+
+    paused_ = false;
+    if(has_method()) {
+        Cudd_AutodynEnable(dd, methods_[method_idx_]);
+    }
+}
+
+void ReorderScheduler::back_off() {
+    growth_ = std::min(2 * growth_, MAX_GROWTH);
+}
+
+unsigned int ReorderScheduler::scaled_threshold(unsigned int threshold) const {
+    return threshold * (growth_ / BASE_GROWTH);
+}
+
+void ReorderScheduler::next_method(DdManager* dd) {
+    num_unproductive_ = 0;
+    ++method_idx_;
+    if(has_method()) {
+        Cudd_AutodynEnable(dd, methods_[method_idx_]);
+    } else {
+        Cudd_AutodynDisable(dd);
+    }
+}
+
+bool ReorderScheduler::within_budget(DdManager* dd) const {
+    //CUDD's reordering time includes any pass which just finished
+    long run_time_ms = util_cpu_time() - start_time_ms_;
+    return Cudd_ReadReorderingTime(dd) <= max_time_frac_ * run_time_ms;
+}
+
+void ReorderScheduler::print_report(std::ostream& os) const {
+    os << "Reordering Schedule:\n";
+    os << "\treorderings: " << num_reorders_ << " (" << num_productive_ << " productive, " << num_over_budget_ << " over budget)\n";
+    os << "\tnodes removed: " << nodes_removed_ << "\n";
+    os << "\ttime budget: " << max_time_frac_ << " of run time\n";
+    os << "\tfinal state: ";
+    if(enabled()) {
+        os << "method " << methods_[method_idx_] << ", next threshold growth " << growth_ << "x\n";
+    } else if(paused_) {
+        os << "paused over budget (method " << methods_[method_idx_] << ", next threshold growth " << growth_ << "x)\n";
+    } else {
+        os << "disabled\n";
+    }
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include <iosfwd>
+#include <vector>
+
+#include "cuddObj.hh"
+
+/*
+ * Schedules CUDD's dynamic variable reordering based on how productive it has been.
+ *
+ * CUDD triggers a reordering whenever the number of nodes exceeds a threshold. After each
+ * reordering (see PreReorderHook() and PostReorderHook()) the scheduler compares the node
+ * reduction achieved against the time spent, and picks the next threshold:
+ *
+ *   - Productive passes (which shrink the BDDs substantially) keep the default threshold of
+ *     twice the current size
+ *   - Unproductive passes double the growth factor of the next threshold (backing off), and
+ *     repeated unproductive passes switch to a cheaper method, or finally turn reordering off
+ *   - Once the total reordering time exceeds the budgeted fraction of the run time the next
+ *     threshold is backed off (even after a productive pass) and reordering is paused, so the
+ *     rest of the analysis can catch up. Reordering resumes (see check_budget()) once the run
+ *     time is back within budget
+ */
+class ReorderScheduler {
+    public:
+        ReorderScheduler();
+
+        ///Enables dynamic reordering on the manager
+        ///\param cudd The manager to schedule reordering for
+        ///\param method The initial reordering method (CUDD_REORDER_NONE disables reordering)
+        ///\param max_time_frac The maximum fraction of the run time (since now) to spend reordering
+        void configure(Cudd& cudd, Cudd_ReorderingType method, double max_time_frac);
+
+        ///Called (by PreReorderHook()) before each reordering
+        void begin_reorder(DdManager* dd);
+
+        ///Called (by PostReorderHook()) after each reordering, to schedule the next one
+        ///\param dd The manager which was reordered
+        ///\param reorder_time_ms The time taken by the reordering
+        void end_reorder(DdManager* dd, unsigned long reorder_time_ms);
+
+        ///Resumes reordering paused for exceeding the time budget, once the run time is back within budget.
+        ///Called when the analysis resets the reordering threshold, since no reorderings run while paused.
+        void check_budget(DdManager* dd);
+
+        ///Backs off the next threshold as if after an unproductive reordering, e.g. when starting from a known good order
+        void back_off();
+
+        ///\returns The threshold scaled by the current back-off.
+        ///Used when the analysis resets the reordering threshold, so a reset does not undo the back-off.
+        unsigned int scaled_threshold(unsigned int threshold) const;
+
+        ///\returns true if dynamic reordering is enabled (neither paused nor turned off)
+        bool enabled() const { return !paused_ && has_method(); }
+
+        ///\returns true if dynamic reordering is paused for exceeding the time budget
+        bool paused() const { return paused_; }
+
+        ///Prints the reordering summary
+        void print_report(std::ostream& os) const;
+
+    private:
+        //Switches to the next (cheaper) method, or disables reordering if none remain
+        void next_method(DdManager* dd);
+
+        //\returns true if a reordering method remains (i.e. reordering has not been turned off)
+        bool has_method() const { return method_idx_ < methods_.size(); }
+
+        //\returns true if the total reordering time is within the budgeted fraction of the run time
+        bool within_budget(DdManager* dd) const;
+
+    private:
+        double max_time_frac_;
+        long start_time_ms_; //CPU time when configured
+
+        std::vector<Cudd_ReorderingType> methods_; //From most to least expensive
+        size_t method_idx_;
+        bool paused_; //Reordering is paused until the run time is back within budget
+
+        double growth_; //Factor applied to the current size to get the next threshold
+        size_t num_unproductive_; //Consecutive unproductive passes with the current method
+        long nodes_before_; //Size before the current reordering
+
+        size_t num_reorders_;
+        size_t num_productive_;
+        size_t num_over_budget_;
+        long nodes_removed_;
+};
+
+//The global reorder scheduler, for the global CUDD manager
+extern ReorderScheduler g_reorder_scheduler;
@@ -0,0 +1,102 @@
+#include "ScenarioStore.hpp"
+#include "ExtTimingTag.hpp"
+
+ScenarioStore g_scenario_store;
+
+ScenarioStore::~ScenarioStore() {
+    clear();
+}
+
+TagId ScenarioStore::allocate_tag() {
+    return tags_.allocate(1);
+}
+
+ScenarioId ScenarioStore::make_leaf(const TagId* tag_ids, size_t num_tags) {
+    ScenarioId node = words_.allocate(1 + num_tags);
+    uint32_t* words = words_.data(node);
+
+    words[0] = make_header(NodeType::LEAF, num_tags);
+    std::copy(tag_ids, tag_ids + num_tags, words + 1);
+
+    return node;
+}
+
+ScenarioId ScenarioStore::make_product(const std::vector<std::vector<TagId>>& alternatives) {
+    size_t num_words = 1;
+    for(const auto& input_alternatives : alternatives) {
+        num_words += 1 + input_alternatives.size();
+    }
+
+    ScenarioId node = words_.allocate(num_words);
+    uint32_t* words = words_.data(node);
+
+    *words++ = make_header(NodeType::PRODUCT, alternatives.size());
+    for(const auto& input_alternatives : alternatives) {
+        *words++ = input_alternatives.size();
+        words = std::copy(input_alternatives.begin(), input_alternatives.end(), words);
+    }
+
+    return node;
+}
+
+ScenarioId ScenarioStore::make_union(ScenarioId lhs, ScenarioId rhs) {
+    if(lhs == INVALID_SCENARIO_ID) return rhs;
+    if(rhs == INVALID_SCENARIO_ID) return lhs;
+
+    ScenarioId node = words_.allocate(3);
+    uint32_t* words = words_.data(node);
+
+    words[0] = make_header(NodeType::UNION, 2);
+    words[1] = lhs;
+    words[2] = rhs;
+
+    return node;
+}
+
+size_t ScenarioStore::num_scenarios(ScenarioId root) const {
+    size_t cnt = 0;
+    for_each_scenario(root, [&](const Scenario&) { ++cnt; });
+    return cnt;
+}
+
+bool ScenarioStore::same_scenarios(ScenarioId lhs, ScenarioId rhs) const {
+    if(lhs == rhs) return true;
+
+    std::vector<uint32_t> lhs_words;
+    std::vector<uint32_t> rhs_words;
+    flatten_scenarios(lhs, lhs_words);
+    flatten_scenarios(rhs, rhs_words);
+    return lhs_words == rhs_words;
+}
+
+void ScenarioStore::flatten_scenarios(ScenarioId root, std::vector<uint32_t>& words) const {
+    for_each_scenario(root, [&](const Scenario& scenario) {
+        words.push_back(scenario.num_inputs());
+        for(size_t i = 0; i < scenario.num_inputs(); ++i) {
+            words.push_back(scenario.num_alternatives(i));
+            for(size_t j = 0; j < scenario.num_alternatives(i); ++j) {
+                words.push_back(scenario.alternative(i, j));
+            }
+        }
+    });
+}
+
+size_t ScenarioStore::memory_used() const {
+    return words_.size() * sizeof(uint32_t) + tags_.size() * sizeof(ExtTimingTag);
+}
+
+void ScenarioStore::write(std::ostream& os) const {
+    tags_.write(os);
+    words_.write(os);
+}
+
+void ScenarioStore::read(std::istream& is) {
+    clear();
+    tags_.read(is);
+    words_.read(is);
+}
+
+void ScenarioStore::clear() {
+    tags_.clear();
+    words_.clear();
+}
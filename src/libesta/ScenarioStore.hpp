@@ -0,0 +1,183 @@
+#pragma once
+#include <cstdint>
+#include <iosfwd>
+#include <limits>
+#include <vector>
+
+#include "ConcurrentArena.hpp"
+
+class ExtTimingTag;
+
+typedef uint32_t TagId; //Identifies a tag registered with the ScenarioStore
+typedef uint32_t ScenarioId; //Identifies a set of switching scenarios in the ScenarioStore
+
+const TagId INVALID_TAG_ID = std::numeric_limits<TagId>::max();
+const ScenarioId INVALID_SCENARIO_ID = std::numeric_limits<ScenarioId>::max();
+
+/*
+ * Arena storage for ExtTimingTags, and compact storage for the switching scenarios (i.e. the
+ * input tags) which generate each tag.
+ *
+ * Tags are allocated from per-analysis chunks (rather than individually from the heap) and
+ * are identified by 32-bit ids.  They are never freed individually; instead everything is
+ * released at once when the analysis is reset.
+ *
+ * Scenarios are stored as nodes in a flat arena of 32-bit words, and refer to tags by their
+ * 32-bit ids.  Each node starts with a header word (the node type and a count):
+ *
+ *   LEAF:    [header(n), tag_0, ..., tag_n-1]
+ *            A single scenario, one tag per input
+ *
+ *   PRODUCT: [header(n), cnt_0, tag_0_0, ..., tag_0_cnt_0-1, ..., cnt_n-1, ...]
+ *            A factored set of scenarios: any combination of one of the alternative tags of
+ *            each of the n inputs
+ *
+ *   UNION:   [header(2), lhs, rhs]
+ *            The scenarios of both child nodes (lhs first)
+ *
+ * Nodes are immutable once created, so merging two tags' scenarios only creates a new UNION
+ * node referencing them (rather than copying them).
+ *
+ * Tags and nodes may be created concurrently from multiple threads.
+ */
+class ScenarioStore {
+    public:
+        enum class NodeType : uint32_t {
+            LEAF = 0,
+            PRODUCT = 1,
+            UNION = 2
+        };
+
+        //A view of a single (possibly factored) scenario, as a set of alternative tags for each input.
+        //A LEAF scenario has exactly one alternative per input.
+        class Scenario {
+            public:
+                size_t num_inputs() const { return input_offsets_.size(); }
+                size_t num_alternatives(size_t input) const { return (product_) ? store_->words_[input_offsets_[input]] : 1; }
+                TagId alternative(size_t input, size_t i) const { return store_->words_[input_offsets_[input] + ((product_) ? 1 + i : 0)]; }
+                const ExtTimingTag* alternative_tag(size_t input, size_t i) const { return store_->tag(alternative(input, i)); }
+
+            private:
+                friend class ScenarioStore;
+                Scenario(const ScenarioStore* store) : store_(store), product_(false) {}
+
+                const ScenarioStore* store_;
+                bool product_;
+                std::vector<uint32_t> input_offsets_; //Word offset of each input's tag (LEAF) or count (PRODUCT)
+        };
+
+    public:
+        ScenarioStore() = default;
+        ScenarioStore(const ScenarioStore&) = delete;
+        ScenarioStore& operator=(const ScenarioStore&) = delete;
+        ~ScenarioStore();
+
+        ///Allocates a (default constructed) tag, which remains valid until the store is cleared
+        ///\returns The tag's id
+        ///\see ExtTimingTag::make_ptr()
+        TagId allocate_tag();
+
+        ///\returns The tag with the specified id
+        //Note: defined in ExtTimingTag.hpp, since ExtTimingTag must be complete
+        inline ExtTimingTag* tag(TagId id);
+        inline const ExtTimingTag* tag(TagId id) const;
+
+        ///\returns The number of tags allocated
+        size_t num_tags() const { return tags_.size(); }
+
+        ///\returns A LEAF node for the scenario with the specified tags
+        ScenarioId make_leaf(const TagId* tag_ids, size_t num_tags);
+
+        ///\returns A PRODUCT node for the specified alternative tags of each input
+        ScenarioId make_product(const std::vector<std::vector<TagId>>& alternatives);
+
+        ///\returns A node with the scenarios of lhs followed by those of rhs (either may be invalid, i.e. empty)
+        ScenarioId make_union(ScenarioId lhs, ScenarioId rhs);
+
+        ///Calls func(const Scenario&) for each scenario reachable from root, in order
+        template<class Func>
+        void for_each_scenario(ScenarioId root, Func func) const;
+
+        ///\returns The number of (possibly factored) scenarios reachable from root
+        size_t num_scenarios(ScenarioId root) const;
+
+        ///\returns true if lhs and rhs describe the same scenarios (in the same order), even if stored as different nodes
+        bool same_scenarios(ScenarioId lhs, ScenarioId rhs) const;
+
+        ///\returns The approximate memory used by the store in bytes
+        size_t memory_used() const;
+
+        ///Writes all tags and scenarios. Not thread-safe.
+        void write(std::ostream& os) const;
+
+        ///Replaces all tags and scenarios with those written by write(), so they keep their ids. Not thread-safe.
+        void read(std::istream& is);
+
+        ///Releases all tags and scenarios, invalidating all pointers to them. Not thread-safe.
+        void clear();
+
+    private:
+        //Appends each scenario's (input count, and each input's alternative count and tags) to words
+        void flatten_scenarios(ScenarioId root, std::vector<uint32_t>& words) const;
+
+        static uint32_t make_header(NodeType type, size_t count) { return (static_cast<uint32_t>(type) << 30) | static_cast<uint32_t>(count); }
+        static NodeType header_type(uint32_t header) { return static_cast<NodeType>(header >> 30); }
+        static size_t header_count(uint32_t header) { return header & ((uint32_t(1) << 30) - 1); }
+
+    private:
+        ConcurrentArena<uint32_t> words_;
+        ConcurrentArena<ExtTimingTag,16> tags_;
+};
+
+//The global scenario store used by ExtTimingTags
+extern ScenarioStore g_scenario_store;
+
+/*
+ * Implementation
+ */
+template<class Func>
+void ScenarioStore::for_each_scenario(ScenarioId root, Func func) const {
+    if(root == INVALID_SCENARIO_ID) return;
+
+    Scenario scenario(this);
+
+    std::vector<ScenarioId> stack = {root};
+    while(!stack.empty()) {
+        ScenarioId node = stack.back();
+        stack.pop_back();
+
+        uint32_t header = words_[node];
+        size_t count = header_count(header);
+        switch(header_type(header)) {
+            case NodeType::UNION:
+                //Visit lhs first
+                stack.push_back(words_[node + 2]);
+                stack.push_back(words_[node + 1]);
+                break;
+
+            case NodeType::LEAF:
+                scenario.product_ = false;
+                scenario.input_offsets_.resize(count);
+                for(size_t i = 0; i < count; ++i) {
+                    scenario.input_offsets_[i] = node + 1 + i;
+                }
+                func(scenario);
+                break;
+
+            case NodeType::PRODUCT: {
+                scenario.product_ = true;
+                scenario.input_offsets_.resize(count);
+                uint32_t offset = node + 1;
+                for(size_t i = 0; i < count; ++i) {
+                    scenario.input_offsets_[i] = offset;
+                    offset += 1 + words_[offset];
+                }
+                func(scenario);
+                break;
+            }
+
+            default:
+                assert(false);
+        }
+    }
+}
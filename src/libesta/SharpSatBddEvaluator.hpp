@@ -2,9 +2,15 @@
 #include <memory>
 #include <random>
 #include <iostream>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "SharpSatEvaluator.hpp"
 #include "CuddSharpSatFraction.h"
+#include "MemoryGovernor.hpp"
+#include "var_order.hpp"
+#include "ReorderScheduler.hpp"
+#include "object_cache.hpp"
 
 #define USE_BDD_CACHE
 
@@ -21,9 +27,9 @@ enum class ConditionFunctionType {
 template<class Analyzer>
 class SharpSatBddEvaluator : public SharpSatEvaluator<Analyzer> {
     private:
-        typedef ObjectCacheMap<ExtTimingTag::cptr,BDD> BddCache;
+        typedef ObjectCache<ExtTimingTag::cptr,BDD> BddCache;
     public:
-        SharpSatBddEvaluator(const TimingGraph& tg, ConditionFunctionType cond_func_type, size_t cond_func_seed, size_t nvars_per_input, std::shared_ptr<Analyzer> analyzer)
+        SharpSatBddEvaluator(const TimingGraph& tg, ConditionFunctionType cond_func_type, size_t cond_func_seed, size_t nvars_per_input, InputVarOrder var_order, const std::vector<InputVar>& saved_var_order, std::shared_ptr<Analyzer> analyzer)
             : SharpSatEvaluator<Analyzer>(tg, analyzer)
             , nvars_per_input_(nvars_per_input)
             , cond_func_type_(cond_func_type)
@@ -49,6 +55,12 @@ class SharpSatBddEvaluator : public SharpSatEvaluator<Analyzer> {
                         const_gens_.insert(node_id);
                     }
                 }
+
+                std::map<NodeId,std::vector<BDD>> input_vars;
+                for(const auto& kv : pi_curr_bdd_vars_) {
+                    input_vars[kv.first] = {kv.second, pi_next_bdd_vars_[kv.first]};
+                }
+                order_input_vars(tg, var_order, saved_var_order, input_vars, {"curr", "next"});
             } else if (cond_func_type == ConditionFunctionType::NON_UNIFORM_ROUND_ROBIN || cond_func_type == ConditionFunctionType::NON_UNIFORM_GROUPED_BY_BINARY_MINTERM || cond_func_type == ConditionFunctionType::NON_UNIFORM_GROUPED_BY_GRAY_MINTERM) {
                 //Collect primary inputs and identify constant generators
                 std::vector<NodeId> primary_inputs;
@@ -61,16 +73,25 @@ class SharpSatBddEvaluator : public SharpSatEvaluator<Analyzer> {
                     }
                 }
 
-                auto rng = std::default_random_engine(cond_func_seed_);
-                size_t num_minterms = 1 << nvars_per_input_;
-
                 for (NodeId pi_node : primary_inputs) {
                     //Create the associated BDD vars
                     for (size_t ivar = 0; ivar < nvars_per_input_; ++ivar) {
                         pi_bdd_vars_[pi_node].push_back(g_cudd.bddVar());
                         g_cudd.pushVariableName("n" + std::to_string(pi_node) + "_" + std::to_string(ivar));
                     }
+                }
 
+                //Order the vars before building the condition functions over them
+                std::vector<std::string> var_roles;
+                for (size_t ivar = 0; ivar < nvars_per_input_; ++ivar) {
+                    var_roles.push_back(std::to_string(ivar));
+                }
+                order_input_vars(tg, var_order, saved_var_order, pi_bdd_vars_, var_roles);
+
+                auto rng = std::default_random_engine(cond_func_seed_);
+                size_t num_minterms = 1 << nvars_per_input_;
+
+                for (NodeId pi_node : primary_inputs) {
                     //Randomly assign numbers of minterms
                     int free_minterms = num_minterms;
                     for (auto trans : {TransitionType::RISE, TransitionType::FALL, TransitionType::HIGH}) {
@@ -120,16 +141,64 @@ class SharpSatBddEvaluator : public SharpSatEvaluator<Analyzer> {
             } else {
                 assert(false && "invalid condition function type");
             }
-            bdd_cache_ = BddCache(false);
 
         }
 
         double count_sat_fraction(ExtTimingTag::cptr tag) override {
             BDD f = build_bdd_xfunc(tag);
+            release_xfunc(tag);
 
             return bdd_sharpsat_fraction(f);
         }
 
+        std::vector<double> count_sat_fractions(const std::vector<ExtTimingTag::cptr>& tags) override {
+            //Build all the xfuncs first, so no garbage collection/reordering (which would clear
+            //the minterm fraction memo) occurs while they are counted in a single sweep
+            std::vector<BDD> fs;
+            std::vector<DdNode*> nodes;
+            for(ExtTimingTag::cptr tag : tags) {
+                fs.push_back(build_bdd_xfunc(tag));
+                nodes.push_back(fs.back().getNode());
+            }
+            for(ExtTimingTag::cptr tag : tags) {
+                release_xfunc(tag);
+            }
+
+            return CountMintermFractions(nodes);
+        }
+
+        void plan_xfuncs(const std::vector<ExtTimingTag::cptr>& roots) override {
+            xfunc_refs_.clear();
+            live_xfuncs_.clear();
+
+            //Each root is consumed once by the external request for its sat fraction
+            std::vector<ExtTimingTag::cptr> stack;
+            for(ExtTimingTag::cptr root : roots) {
+                if(xfunc_refs_[root]++ == 0) {
+                    stack.push_back(root);
+                }
+            }
+
+            //Each planned tag consumes its source tags once per reference in its scenarios
+            while(!stack.empty()) {
+                ExtTimingTag::cptr tag = stack.back();
+                stack.pop_back();
+
+                if(pinned_xfuncs_.count(tag)) continue; //Never built
+
+                for_each_src_tag(tag, [&](ExtTimingTag::cptr src_tag) {
+                    if(xfunc_refs_[src_tag]++ == 0) {
+                        stack.push_back(src_tag); //First reference
+                    }
+                });
+            }
+        }
+
+        void end_plan() override {
+            xfunc_refs_.clear();
+            live_xfuncs_.clear();
+        }
+
         void reset() override { 
             int i = 0;
             for(auto& cudd : {g_cudd}) {
@@ -141,7 +210,8 @@ class SharpSatBddEvaluator : public SharpSatEvaluator<Analyzer> {
                 std::cout << "\treorder_time: " << (float) cudd.ReadReorderingTime() / 1000 << "\n";
                 i++;
             }
-            bdd_cache_ = BddCache(false);
+            //Planned xfuncs are retained, since they are freed as soon as their consumers are done
+            bdd_cache_.clear();
 
             //Reset the default re-order size
             //Re-ordering really big BDDs is slow (re-order time appears to be quadratic in size)
@@ -151,7 +221,49 @@ class SharpSatBddEvaluator : public SharpSatEvaluator<Analyzer> {
              *g_cudd.SetNextReordering(next_reorder);
              */
 
-             g_cudd.SetNextReordering(4096);
+             g_reorder_scheduler.check_budget(g_cudd.getManager());
+             g_cudd.SetNextReordering(g_reorder_scheduler.scaled_threshold(4096));
+        }
+
+        ///\returns The current order of the primary input variables (from top to bottom), e.g. to save for later runs
+        std::vector<InputVar> input_var_order() const {
+            std::vector<InputVar> var_order;
+            for(int level = 0; level < g_cudd.ReadSize(); ++level) {
+                auto iter = input_vars_by_index_.find(g_cudd.ReadInvPerm(level));
+                if(iter != input_vars_by_index_.end()) {
+                    var_order.push_back(iter->second);
+                }
+            }
+            return var_order;
+        }
+
+        ///Provides the xfuncs of some tags (e.g. loaded from a checkpoint), which are used rather than building them
+        void pin_xfuncs(const std::vector<ExtTimingTag::cptr>& tags, const std::vector<BDD>& xfuncs) {
+            assert(tags.size() == xfuncs.size());
+            for(size_t i = 0; i < tags.size(); ++i) {
+                pinned_xfuncs_[tags[i]] = xfuncs[i];
+            }
+        }
+
+        ///Limits the size (in BDD nodes) of the cached unplanned xfuncs (zero implies no limit)
+        void set_xfunc_cache_node_budget(size_t val) { bdd_cache_.set_cost_capacity(val); }
+
+        ///\returns The number of xfuncs built so far (i.e. requests not satisfied by a live, cached or pinned xfunc)
+        size_t num_xfuncs_built() const { return num_xfuncs_built_; }
+
+        ///Evicts half of the cached unplanned xfuncs (by size), e.g. under memory pressure.
+        ///Planned xfuncs are retained, since they are still needed (and will be freed once consumed)
+        void relieve_memory_pressure() { bdd_cache_.evict_to_cost(bdd_cache_.total_cost() / 2); }
+
+        void invalidate(const std::vector<ExtTimingTag::cptr>& tags) override {
+            //Tags which are unchanged by an incremental update keep their identity, and tags derived from
+            //replaced tags are new tags, so only the replaced tags' xfuncs need to be discarded
+            for(ExtTimingTag::cptr tag : tags) {
+                bdd_cache_.erase(tag);
+                xfunc_refs_.erase(tag);
+                live_xfuncs_.erase(tag);
+                pinned_xfuncs_.erase(tag);
+            }
         }
 
         BDD build_bdd_xfunc(ExtTimingTag::cptr tag, int level=0) {
@@ -164,36 +276,36 @@ class SharpSatBddEvaluator : public SharpSatEvaluator<Analyzer> {
             std::cout << tab << "Requested BDD for " << node_id << " " << tag << " " << this->tg_.node_type(node_id) << "\n";
 #endif
 
-            if(!bdd_cache_.contains(key)) {
-                //Not found calculate it
+            auto pinned_iter = pinned_xfuncs_.find(key);
+            if(pinned_iter != pinned_xfuncs_.end()) {
+                return pinned_iter->second;
+            }
 
-                BDD f;
-                const auto& input_tags = tag->input_tags();
-                if(input_tags.empty()) {
-                    //std::cout << "Node " << tag.launch_node() << " Base";
-                    f = generate_pi_switch_func(tag->launch_node(), tag->trans_type());
-                    //std::cout << " xfunc: " << f << "\n";
-                } else {
-                    //Recursive case
-                    f = g_cudd.bddZero();
-                    //int scenario_cnt = 0;
+            auto live_iter = live_xfuncs_.find(key);
+            if(live_iter != live_xfuncs_.end()) {
+                //Planned and still live
+                return live_iter->second;
+            } else if(has_planned_consumers(key)) {
+                //Planned, build it (and any of its planned sources) bottom-up
+                return build_planned_xfunc(tag);
+            }
 
-                    for(const auto& transition_scenario : input_tags) {
-                        BDD f_scenario = g_cudd.bddOne();
+            //Unplanned, or a planned tag whose consumers are all done (e.g. re-requested after the plan),
+            //which is cached so shared sources are not rebuilt
 
-                        for(const auto src_tag : transition_scenario) {
-                            f_scenario &= this->build_bdd_xfunc(src_tag, level+1);
-                        }
+            BDD* cached_f = bdd_cache_.find(key);
+            if(!cached_f) {
+                //Not found calculate it
 
-                        f |= f_scenario;
-                        //std::cout << "Node " << node_id << " Scenario: " << scenario_cnt;
-                        //std::cout << " xfunc: " << f << "\n";
-                        //scenario_cnt++;
-                    }
-                }
+                BDD f = build_tag_xfunc(tag, [&](ExtTimingTag::cptr src_tag) {
+                    return this->build_bdd_xfunc(src_tag, level+1);
+                });
+
+                //Calulcated it, save it (weighted by its size, which approximates the cost to rebuild it)
+                bdd_cache_.insert(key, f, f.nodeCount());
+                ++num_xfuncs_built_;
 
-                //Calulcated it, save it
-                bdd_cache_.insert(key, f);
+                g_memory_governor.check();
 
 #ifdef BDD_CALC_DEBUG
                 std::cout << tab << "Calculated BDD for " << node_id << " " << tag << " " << this->tg_.node_type(node_id) << " #SAT: " << bdd_sharpsat(f) << " " << f << "\n";
@@ -201,7 +313,7 @@ class SharpSatBddEvaluator : public SharpSatEvaluator<Analyzer> {
 
                 return f;
             } else {
-                BDD f = bdd_cache_.value(key);
+                BDD f = *cached_f;
 #ifdef BDD_CALC_DEBUG
                 std::cout << tab << "Looked up  BDD for " << node_id << " " << tag << " " << this->tg_.node_type(node_id) << " #SAT: " << bdd_sharpsat(f) << "\n";
 #endif
@@ -212,6 +324,128 @@ class SharpSatBddEvaluator : public SharpSatEvaluator<Analyzer> {
         }
 
     protected:
+        //Places and groups the primary input variables (following the saved order if any), and records their roles
+        void order_input_vars(const TimingGraph& tg, InputVarOrder var_order, const std::vector<InputVar>& saved_var_order,
+                              const std::map<NodeId,std::vector<BDD>>& input_vars, const std::vector<std::string>& var_roles) {
+            for(const auto& kv : input_vars) {
+                for(size_t i = 0; i < kv.second.size(); ++i) {
+                    input_vars_by_index_[kv.second[i].NodeReadIndex()] = InputVar(kv.first, var_roles[i]);
+                }
+            }
+
+            auto var_groups = order_input_var_groups(order_input_nodes(tg, var_order), input_vars, var_roles, saved_var_order);
+            apply_input_var_order(g_cudd, var_groups);
+        }
+
+        //Builds the xfunc of tag from those of its source tags (as returned by src_xfunc(src_tag))
+        template<class SrcXfunc>
+        BDD build_tag_xfunc(ExtTimingTag::cptr tag, SrcXfunc src_xfunc) {
+            if(tag->is_launch_tag()) {
+                return generate_pi_switch_func(tag->launch_node(), tag->trans_type());
+            }
+
+            BDD f = g_cudd.bddZero();
+
+            //Each scenario is an AND over the inputs of the OR of each input's alternative tags
+            //(non-factored scenarios have a single alternative per input)
+            g_scenario_store.for_each_scenario(tag->scenarios(), [&](const ScenarioStore::Scenario& scenario) {
+                BDD f_scenario = g_cudd.bddOne();
+
+                for(size_t i = 0; i < scenario.num_inputs(); ++i) {
+                    BDD f_input = g_cudd.bddZero();
+                    for(size_t j = 0; j < scenario.num_alternatives(i); ++j) {
+                        f_input |= src_xfunc(scenario.alternative_tag(i, j));
+                    }
+                    f_scenario &= f_input;
+                }
+
+                f |= f_scenario;
+            });
+
+            return f;
+        }
+
+        //Calls func(src_tag) for each reference to a source tag in tag's scenarios
+        template<class Func>
+        void for_each_src_tag(ExtTimingTag::cptr tag, Func func) {
+            if(tag->is_launch_tag()) return;
+
+            g_scenario_store.for_each_scenario(tag->scenarios(), [&](const ScenarioStore::Scenario& scenario) {
+                for(size_t i = 0; i < scenario.num_inputs(); ++i) {
+                    for(size_t j = 0; j < scenario.num_alternatives(i); ++j) {
+                        func(scenario.alternative_tag(i, j));
+                    }
+                }
+            });
+        }
+
+        //Builds the xfunc of a planned tag bottom-up: all of its planned sources which are not live
+        //are built first (in topological order), and each source is released as it is consumed
+        BDD build_planned_xfunc(ExtTimingTag::cptr root) {
+            //Post-order (i.e. topological, sources first) walk of the tags which need to be built
+            std::vector<ExtTimingTag::cptr> build_order;
+            std::unordered_set<ExtTimingTag::cptr> visited = {root};
+            std::vector<std::pair<ExtTimingTag::cptr,bool>> stack = {{root, false}};
+            while(!stack.empty()) {
+                ExtTimingTag::cptr tag = stack.back().first;
+                bool expanded = stack.back().second;
+                stack.pop_back();
+
+                if(expanded) {
+                    build_order.push_back(tag);
+                    continue;
+                }
+
+                stack.emplace_back(tag, true);
+                for_each_src_tag(tag, [&](ExtTimingTag::cptr src_tag) {
+                    bool needs_build = has_planned_consumers(src_tag) && !live_xfuncs_.count(src_tag) && !pinned_xfuncs_.count(src_tag);
+                    if(needs_build && visited.insert(src_tag).second) {
+                        stack.emplace_back(src_tag, false);
+                    }
+                });
+            }
+
+            for(ExtTimingTag::cptr tag : build_order) {
+                BDD f = build_tag_xfunc(tag, [&](ExtTimingTag::cptr src_tag) {
+                    auto iter = live_xfuncs_.find(src_tag);
+                    if(iter != live_xfuncs_.end()) {
+                        return iter->second;
+                    }
+                    //A pinned or unplanned source, or one whose consumers are all done
+                    return this->build_bdd_xfunc(src_tag);
+                });
+                live_xfuncs_[tag] = f;
+                ++num_xfuncs_built_;
+
+                //This tag has consumed its sources
+                for_each_src_tag(tag, [&](ExtTimingTag::cptr src_tag) {
+                    release_xfunc(src_tag);
+                });
+
+                g_memory_governor.check();
+            }
+
+            return live_xfuncs_[root];
+        }
+
+        //Whether a tag is planned and some of its planned consumers have yet to use its xfunc
+        bool has_planned_consumers(ExtTimingTag::cptr tag) const {
+            auto iter = xfunc_refs_.find(tag);
+            return iter != xfunc_refs_.end() && iter->second > 0;
+        }
+
+        //Records that one consumer of a planned tag's xfunc is done, freeing the xfunc once all are
+        void release_xfunc(ExtTimingTag::cptr tag) {
+            auto iter = xfunc_refs_.find(tag);
+            if(iter == xfunc_refs_.end()) return; //Unplanned
+
+            if(iter->second > 0) {
+                --iter->second;
+            }
+            if(iter->second == 0) {
+                live_xfuncs_.erase(tag);
+            }
+        }
 
         double bdd_sharpsat_fraction(BDD f) {
             double dbl_count_custom_frac = CountMintermFraction(f.getNode());
@@ -467,11 +701,20 @@ class SharpSatBddEvaluator : public SharpSatEvaluator<Analyzer> {
         std::unordered_map<NodeId,BDD> pi_next_bdd_vars_;
         std::unordered_set<NodeId> const_gens_;
         std::map<NodeId,std::vector<BDD>> pi_bdd_vars_;
+        std::unordered_map<int,InputVar> input_vars_by_index_; //Identifies each primary input variable
 
         std::map<NodeId,std::map<TransitionType,size_t>> assigned_minterm_counts_;
         ConditionFunctionType  cond_func_type_;
         size_t cond_func_seed_;
         std::map<NodeId,std::map<TransitionType,BDD>> cond_funcs_;
 
-        BddCache bdd_cache_;
+        BddCache bdd_cache_; //Unplanned xfuncs
+
+        //Planned xfuncs (see plan_xfuncs())
+        std::unordered_map<ExtTimingTag::cptr,size_t> xfunc_refs_; //Remaining consumers of each planned tag
+        std::unordered_map<ExtTimingTag::cptr,BDD> live_xfuncs_; //Built xfuncs with remaining consumers
+
+        std::unordered_map<ExtTimingTag::cptr,BDD> pinned_xfuncs_; //Provided xfuncs (see pin_xfuncs())
+
+        size_t num_xfuncs_built_ = 0;
 };
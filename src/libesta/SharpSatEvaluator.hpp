@@ -1,5 +1,6 @@
 #pragma once
 #include <memory>
+#include <vector>
 #include "timing_graph_fwd.hpp"
 #include "ExtTimingTag.hpp"
 
@@ -12,8 +13,28 @@ class SharpSatEvaluator {
         virtual ~SharpSatEvaluator() {}
 
         virtual double count_sat_fraction(ExtTimingTag::cptr tag) = 0;
+
+        ///\returns The sat fraction of each of the tags (e.g. all the tags at a node)
+        virtual std::vector<double> count_sat_fractions(const std::vector<ExtTimingTag::cptr>& tags) {
+            std::vector<double> fracs;
+            for(ExtTimingTag::cptr tag : tags) {
+                fracs.push_back(count_sat_fraction(tag));
+            }
+            return fracs;
+        }
+
         virtual void reset() {}
 
+        ///Plans the evaluation of the specified tags (e.g. all those whose sat fractions will be counted),
+        ///allowing intermediate results to be shared between them and freed once no longer needed
+        virtual void plan_xfuncs(const std::vector<ExtTimingTag::cptr>& /*roots*/) {}
+
+        ///Ends the current plan (see plan_xfuncs()), so later requests are evaluated (and cached) as unplanned
+        virtual void end_plan() {}
+
+        ///Discards any results cached for the specified tags (e.g. those replaced by an incremental update)
+        virtual void invalidate(const std::vector<ExtTimingTag::cptr>& /*tags*/) {}
+
     protected:
         const TimingGraph& tg_;
         std::shared_ptr<Analyzer> analyzer_;
@@ -1,61 +1,85 @@
+#include <cassert>
 #include "TagPermutationGenerator.hpp"
 
+constexpr size_t TagPermutationGenerator::ALL_INPUTS;
+
 TagPermutationGenerator::TagPermutationGenerator(std::vector<ExtTimingTags> input_tag_sets)
-    : input_tag_sets_(input_tag_sets)
-    , iterators_(input_tag_sets_.size())
-    , done_(false) {
-    initialize();    
-}
+    : input_tag_sets_(std::move(input_tag_sets))
+    , num_permutations_(1)
+    , counter_digits_(input_tag_sets_.size(), 0)
+    , gray_digits_(input_tag_sets_.size(), 0)
+    , reflected_(input_tag_sets_.size(), false)
+    , current_(input_tag_sets_.size(), nullptr)
+    , changed_input_(ALL_INPUTS)
+    , perm_idx_(0)
+    , end_perm_(0) {
 
-void TagPermutationGenerator::initialize() {
-    for(size_t i = 0; i < input_tag_sets_.size(); i++) {
-        iterators_[i] = input_tag_sets_[i].begin();
+    for(size_t i = 0 ; i < input_tag_sets_.size(); i++) {
+        num_permutations_ *= input_tag_sets_[i].num_tags();    
     }
+    set_range(0, num_permutations_);
 }
 
-void TagPermutationGenerator::advance() {
-    bool carry = true; //Initialize a carry in at input 0
+void TagPermutationGenerator::set_range(size_t begin_perm, size_t end_perm) {
+    assert(begin_perm <= end_perm);
+    end_perm_ = std::min(end_perm, num_permutations_);
+    seek(begin_perm);
+}
+
+void TagPermutationGenerator::seek(size_t perm_idx) {
+    perm_idx_ = perm_idx;
+    changed_input_ = ALL_INPUTS;
+
+    if(done()) return;
+
+    //Decompose the permutation index into its mixed-radix digits.
+    //
+    //In a reflected Gray code a digit counts down (i.e. is reflected) when the
+    //value of the more significant digits is odd
+    size_t remainder = perm_idx;
     for(size_t i = 0; i < input_tag_sets_.size(); i++) {
-        if(carry) {
-            //Advance by one step
-            ++iterators_[i];
-            carry = false;
-        }
+        size_t radix = input_tag_sets_[i].num_tags();
+        assert(radix > 0);
 
-        if(iterators_[i] == input_tag_sets_[i].end()) {
-            //If we are at the end, carry to the next index
-            carry=true;
+        counter_digits_[i] = remainder % radix;
+        remainder /= radix;
 
-            //And reset the current
-            iterators_[i] = input_tag_sets_[i].begin();
-        }
-    }
-    if(carry == true) {
-        //Overflow, indicating that we have finished iteration
-        done_ = true;
+        reflected_[i] = (remainder % 2 == 1);
+        gray_digits_[i] = reflected_[i] ? radix - 1 - counter_digits_[i] : counter_digits_[i];
+        current_[i] = input_tag(i, gray_digits_[i]);
     }
 }
 
-std::vector<ExtTimingTag::cptr> TagPermutationGenerator::next() {
-    std::vector<ExtTimingTag::cptr> input_tag_perm(input_tag_sets_.size(), nullptr);
-
-    for(size_t i = 0; i < input_tag_sets_.size(); i++) {
-        input_tag_perm[i] = (*iterators_[i]);
+void TagPermutationGenerator::advance() {
+    ++perm_idx_;
+    if(done()) {
+        changed_input_ = ALL_INPUTS;
+        return;
     }
 
-    advance();
-
-    return input_tag_perm;
-}
+    //Increment the counter. Any digits which wrap around keep the same gray
+    //digit (but change direction), so only the digit which absorbs the carry changes
+    size_t i = 0;
+    for(; i < input_tag_sets_.size(); i++) {
+        if(counter_digits_[i] + 1 < input_tag_sets_[i].num_tags()) {
+            break;
+        }
+        counter_digits_[i] = 0;
+        reflected_[i] = !reflected_[i];
+    }
+    assert(i < input_tag_sets_.size()); //Otherwise we would have been done
 
-bool TagPermutationGenerator::done() {
-    return done_;
+    ++counter_digits_[i];
+    if(reflected_[i]) {
+        --gray_digits_[i];
+    } else {
+        ++gray_digits_[i];
+    }
+    current_[i] = input_tag(i, gray_digits_[i]);
+    changed_input_ = i;
 }
 
-size_t TagPermutationGenerator::num_permutations() {
-    size_t count = 1;
-    for(size_t i = 0 ; i < input_tag_sets_.size(); i++) {
-        count *= input_tag_sets_[i].num_tags();    
-    }
-    return count;
+const ExtTimingTag* TagPermutationGenerator::input_tag(size_t input_idx, size_t tag_idx) const {
+    assert(tag_idx < input_tag_sets_[input_idx].num_tags());
+    return *(input_tag_sets_[input_idx].begin() + tag_idx);
 }
@@ -1,32 +1,73 @@
 #pragma once
+#include <limits>
 #include <vector>
 #include "ExtTimingTags.hpp"
 
 //Lazily generates all permutations of tags in the input_tag_sets
+//
+//The permutations are numbered as a mixed-radix integer (input 0 is the least
+//significant digit), which allows the permutation space to be split into
+//contiguous ranges which can be evaluated independently.
+//
+//The permutations are enumerated in (reflected mixed-radix) Gray code order, so
+//exactly one input's tag changes between consecutive permutations. This allows
+//callers to update any state derived from the current permutation incrementally
+//(see changed_input()).
+//
+//The current permutation is exposed as a view over the generator's storage, so
+//stepping through the permutations performs no allocations.
 class TagPermutationGenerator {
     
     public:
+        //Returned by changed_input() when the whole permutation should be considered changed
+        static constexpr size_t ALL_INPUTS = std::numeric_limits<size_t>::max();
+
         TagPermutationGenerator(std::vector<ExtTimingTags> input_tag_sets);
 
         //Is the generator finished
-        bool done();
+        bool done() const { return perm_idx_ >= end_perm_; }
 
-        size_t num_permutations();
+        size_t num_permutations() const { return num_permutations_; }
 
-        //Gets the next permutation
-        std::vector<ExtTimingTag::cptr> next();
+        size_t num_inputs() const { return input_tag_sets_.size(); }
 
-    private:
-        void initialize();
+        //The index of the current permutation
+        size_t permutation_index() const { return perm_idx_; }
+
+        //The tags of the current permutation (one per input)
+        const std::vector<const ExtTimingTag*>& current() const { return current_; }
+
+        //The input whose tag changed in the last call to advance(), or ALL_INPUTS
+        //if the generator was (re)positioned with seek()
+        size_t changed_input() const { return changed_input_; }
+
+        //Restricts the generator to the permutations [begin_perm, end_perm), and
+        //resets it to the first permutation of the range
+        void set_range(size_t begin_perm, size_t end_perm);
+
+        //Moves the generator to the specified permutation
+        void seek(size_t perm_idx);
+
+        //Moves to the next permutation
         void advance();
 
+    private:
+        const ExtTimingTag* input_tag(size_t input_idx, size_t tag_idx) const;
 
         //The set of input tags
         std::vector<ExtTimingTags> input_tag_sets_;
+        size_t num_permutations_;
 
+        //The generator state.
+        //  counter_digits_ is the mixed-radix representation of the permutation index,
+        //  gray_digits_ are the tag indicies of the current permutation, and reflected_
+        //  notes whether each gray digit is currently counting down
+        std::vector<size_t> counter_digits_;
+        std::vector<size_t> gray_digits_;
+        std::vector<char> reflected_;
+        std::vector<const ExtTimingTag*> current_;
+        size_t changed_input_;
 
-        //The generator state, we keep an iterator for each 'input'
-        //which we advance through piecewise (i.e. like binary increment)
-        std::vector<ExtTimingTags::iterator> iterators_;
-        bool done_;
+        size_t perm_idx_;
+        size_t end_perm_;
 };
@@ -1,4 +1,8 @@
 #pragma once
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+#include <vector>
 
 #include "ExtTimingTags.hpp"
 
@@ -11,6 +15,8 @@ class TagReducer {
     public:
         virtual Tags merge_tags(NodeId node_id, const Tags& orig_tags) const = 0;
         virtual Tags merge_tags(NodeId node_id, const Tags& orig_tags, const double delay_bin_size) const = 0;
+        //The number of tags merge_tags() would produce with a specific bin size (without merging them)
+        virtual size_t num_merged_tags(NodeId node_id, const Tags& orig_tags, const double delay_bin_size) const = 0;
         virtual Tags merge_max_tags(const Tags& orig_tags, int num_nodes) const = 0;
         virtual double default_bin_size() const = 0;
         virtual double default_slack_threshold() const = 0;
@@ -20,6 +26,7 @@ class NoOpTagReducer : public TagReducer {
 
         Tags merge_tags(NodeId /*unused*/, const Tags& orig_tags) const override { return orig_tags; }
         Tags merge_tags(NodeId /*unused*/, const Tags& orig_tags, const double /*unused*/) const override { return orig_tags; }
+        size_t num_merged_tags(NodeId /*unused*/, const Tags& orig_tags, const double /*unused*/) const override { return orig_tags.num_tags(); }
         Tags merge_max_tags(const Tags& orig_tags, int num_nodes) const { return orig_tags; }
         double default_bin_size() const { return 0.; }
         double default_slack_threshold() const { return 0.; }
@@ -59,6 +66,21 @@ class StaSlackTagReducer : public TagReducer {
             }
         }
 
+        size_t num_merged_tags(NodeId node_id, const Tags& orig_tags, const double delay_bin_size) const override {
+            auto arr_threshold = arrival_threshold(node_id);
+            if(!std::isnan(arr_threshold)) {
+                std::vector<size_t> merge_into = assign_bins(orig_tags, delay_bin_size, delay_bin_size, arr_threshold);
+
+                size_t num_bins = 0;
+                for(size_t i = 0; i < merge_into.size(); ++i) {
+                    if(merge_into[i] == i) ++num_bins;
+                }
+                return num_bins;
+            } else {
+                return orig_tags.num_tags();
+            }
+        }
+
         Tags merge_max_tags(const Tags& orig_tags, int num_nodes) const override {
             auto max_req = 0.f;
 
@@ -97,41 +119,17 @@ class StaSlackTagReducer : public TagReducer {
         }
 
         Tags merge_tags(const Tags& orig_tags, const double coarse_delay_bin_size, const double fine_delay_bin_size, const double arr_threshold) const {
-            Tags merged_tags;
+            //Determine which tag each tag is merged into
+            std::vector<size_t> merge_into = assign_bins(orig_tags, coarse_delay_bin_size, fine_delay_bin_size, arr_threshold);
 
+            //Merge the tags in their original order, so the resulting tags (and the
+            //order of their scenarios) are independent of the binning method
+            Tags merged_tags;
+            std::vector<size_t> merged_idx(orig_tags.num_tags()); //Index in merged_tags of each bin's first tag
+            size_t tag_idx = 0;
             for(const auto& tag : orig_tags) {
-
-                //Below threshold, merge if possible
-                auto bin_tag_pred = [&](typename Tags::Tag::cptr search_tag) {
-                    if(tag->trans_type() != search_tag->trans_type()) return false; //Require the same transition
-
-                    //Do not merge tags accross the threshold
-                    if(tag->arr_time().value() > arr_threshold && search_tag->arr_time().value() <= arr_threshold) {
-                        return false;
-                    }
-
-                    auto bin_size = coarse_delay_bin_size; //Default to coarse binning
-                    if(search_tag->arr_time().value() > arr_threshold) {
-                        bin_size = fine_delay_bin_size; //Use fine binning if beyond thershold
-                    }
-
-                    //Map to the appropriate bin, we treat a bin size of zero as no binning
-                    double tag_bin = tag->arr_time().value();
-                    double search_tag_bin = search_tag->arr_time().value();
-
-                    if(bin_size != 0.) {
-                        tag_bin = std::floor(tag_bin / bin_size);
-                        search_tag_bin = std::floor(search_tag_bin / bin_size);
-                    }
-
-                    if(tag_bin != search_tag_bin) return false;
-                    return true;
-                };
-
-                //Get any tag in the same bin (if such a tag exists)
-                auto iter = std::find_if(merged_tags.begin(), merged_tags.end(), bin_tag_pred);
-
-                if(iter != merged_tags.end()) { //Found existing
+                if(merge_into[tag_idx] != tag_idx) { //Merge into an existing bin
+                    auto iter = merged_tags.begin() + merged_idx[merge_into[tag_idx]];
 #ifdef DEBUG_TAG_MERGE
                     auto matched_tag = *iter;
                     if(tag->arr_time().value() > arr_threshold) {
@@ -148,12 +146,121 @@ class StaSlackTagReducer : public TagReducer {
 #ifdef DEBUG_TAG_MERGE
                     std::cout << "No match: adding tag " << tag->trans_type() << "@" << tag->arr_time().value() << "\n";
 #endif
+                    merged_idx[tag_idx] = merged_tags.num_tags();
                     merged_tags.add_tag(tag);
                 }
+                ++tag_idx;
             }
             
             return merged_tags;
         }
+
+        //A tag's delay bin
+        struct BinnedTag {
+            TransitionType trans;
+            bool above_threshold;
+            double bin; //Fine bin if above the threshold, otherwise coarse bin
+            double fine_bin;
+            size_t tag_idx;
+
+            bool same_bin(const BinnedTag& other) const {
+                return trans == other.trans && above_threshold == other.above_threshold && bin == other.bin;
+            }
+
+            bool bin_less(const BinnedTag& other) const {
+                return std::tie(trans, above_threshold, bin) < std::tie(other.trans, other.above_threshold, other.bin);
+            }
+
+            friend bool operator<(const BinnedTag& lhs, const BinnedTag& rhs) {
+                return std::tie(lhs.trans, lhs.above_threshold, lhs.bin, lhs.tag_idx) < std::tie(rhs.trans, rhs.above_threshold, rhs.bin, rhs.tag_idx);
+            }
+        };
+
+        //Returns the index of the tag each tag is merged into (itself if it starts a new bin).
+        //
+        //Each tag is merged into the first earlier tag in the same bin: a tag with the same transition and
+        //delay bin, where tags above the threshold use the fine bin size (and are never merged with tags
+        //below the threshold).  Rather than searching the earlier tags, we sort the tags by
+        //(transition, side of the threshold, bin, index) and sweep the resulting runs of equal bins.
+        std::vector<size_t> assign_bins(const Tags& orig_tags, const double coarse_delay_bin_size, const double fine_delay_bin_size, const double arr_threshold) const {
+            const size_t ntags = orig_tags.num_tags();
+
+            std::vector<size_t> merge_into(ntags);
+            std::vector<BinnedTag> binned_tags;
+            binned_tags.reserve(ntags);
+            size_t tag_idx = 0;
+            for(const auto& tag : orig_tags) {
+                merge_into[tag_idx] = tag_idx;
+
+                double arr = tag->arr_time().value();
+                if(!std::isnan(arr)) { //NaN arrival times never match, so always start a new bin
+                    bool above_threshold = (arr > arr_threshold);
+                    double fine_bin = delay_bin(arr, fine_delay_bin_size);
+                    double bin = (above_threshold) ? fine_bin : delay_bin(arr, coarse_delay_bin_size);
+                    binned_tags.push_back({tag->trans_type(), above_threshold, bin, fine_bin, tag_idx});
+                }
+                ++tag_idx;
+            }
+
+            std::sort(binned_tags.begin(), binned_tags.end());
+
+            //Bins above the threshold only ever contain tags above the threshold, so are
+            //started by their first tag
+            std::vector<BinnedTag> above_bin_starts;
+            for(size_t run_begin = 0; run_begin < binned_tags.size(); ) {
+                size_t run_end = run_begin + 1;
+                while(run_end < binned_tags.size() && binned_tags[run_end].same_bin(binned_tags[run_begin])) ++run_end;
+
+                if(binned_tags[run_begin].above_threshold) {
+                    for(size_t i = run_begin + 1; i < run_end; ++i) {
+                        merge_into[binned_tags[i].tag_idx] = binned_tags[run_begin].tag_idx;
+                    }
+                    above_bin_starts.push_back(binned_tags[run_begin]);
+                }
+                run_begin = run_end;
+            }
+
+            //Tags below the threshold may also be merged into an above threshold tag in the same fine bin
+            //(i.e. the fine bin straddling the threshold) if it started before the tag's own (coarse) bin
+            for(size_t run_begin = 0; run_begin < binned_tags.size(); ) {
+                size_t run_end = run_begin + 1;
+                while(run_end < binned_tags.size() && binned_tags[run_end].same_bin(binned_tags[run_begin])) ++run_end;
+
+                if(!binned_tags[run_begin].above_threshold) {
+                    size_t bin_start = ntags; //The tag starting the coarse bin (ntags if not yet started)
+                    for(size_t i = run_begin; i < run_end; ++i) {
+                        const BinnedTag& binned_tag = binned_tags[i];
+
+                        size_t fine_bin_start = ntags;
+                        BinnedTag fine_key = {binned_tag.trans, true, binned_tag.fine_bin, 0, 0};
+                        auto iter = std::lower_bound(above_bin_starts.begin(), above_bin_starts.end(), fine_key,
+                                                     [](const BinnedTag& lhs, const BinnedTag& rhs) { return lhs.bin_less(rhs); });
+                        if(iter != above_bin_starts.end() && iter->same_bin(fine_key)) {
+                            fine_bin_start = iter->tag_idx;
+                        }
+
+                        if(fine_bin_start < binned_tag.tag_idx && fine_bin_start < bin_start) {
+                            merge_into[binned_tag.tag_idx] = fine_bin_start;
+                        } else if(bin_start != ntags) {
+                            merge_into[binned_tag.tag_idx] = bin_start;
+                        } else {
+                            bin_start = binned_tag.tag_idx;
+                        }
+                    }
+                }
+                run_begin = run_end;
+            }
+
+            return merge_into;
+        }
+
+        //Map to the appropriate bin, we treat a bin size of zero as no binning
+        static double delay_bin(double arr, double bin_size) {
+            if(bin_size != 0.) {
+                return std::floor(arr / bin_size);
+            }
+            return arr;
+        }
     private:
         std::shared_ptr<AnalyzerType> analyzer_;
         double slack_threshold_;
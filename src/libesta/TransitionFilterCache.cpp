@@ -0,0 +1,23 @@
+#include "TransitionFilterCache.hpp"
+
+constexpr size_t TransitionFilterCache::MAX_INPUTS;
+constexpr size_t TransitionFilterCache::MAX_INPUT_IDX;
+constexpr size_t TransitionFilterCache::MAX_TABLE_SIZE;
+
+TransitionFilterCache::Table& TransitionFilterCache::function_table(const BDD& f) {
+    return function_tables_[f];
+}
+
+const TransitionFilterCache::Result* TransitionFilterCache::find(const Table& table, uint64_t key) {
+    auto iter = table.find(key);
+    if(iter == table.end()) {
+        return nullptr;
+    }
+    return &iter->second;
+}
+
+void TransitionFilterCache::insert(Table& table, uint64_t key, const Result& result) {
+    if(table.size() < MAX_TABLE_SIZE) {
+        table[key] = result;
+    }
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <cstdint>
+#include <unordered_map>
+
+#include "bdd.hpp"
+#include "TransitionType.hpp"
+
+/*
+ * Caches the result of evaluating a node's logic function for a sequence of input transitions.
+ *
+ * When a node is evaluated the inputs are applied to the node function in order of arrival,
+ * to determine the output transition and which inputs are filtered (i.e. have no effect on the
+ * output).  The result depends only on the node function, the input transitions and their arrival
+ * order; not on the actual arrival times.  Since the same sequences re-occur across permutations
+ * (and many nodes implement the same function) the results are cached per function, replacing
+ * the BDD restrictions with a table lookup.
+ *
+ * A sequence is encoded as a 64-bit key, with 6 bits for each input in arrival order
+ * (4 bits for the input index and 2 bits for its transition).  Nodes with more inputs
+ * than can be encoded are not cached.
+ */
+class TransitionFilterCache {
+    public:
+        struct Result {
+            TransitionType output_transition;
+            uint16_t unfiltered_inputs; //Bit i is set if input i was not filtered
+        };
+
+        typedef std::unordered_map<uint64_t,Result> Table;
+
+        //The largest number of inputs (and input index) which can be encoded in a key
+        static constexpr size_t MAX_INPUTS = 10;
+        static constexpr size_t MAX_INPUT_IDX = 15;
+
+        //Bound the size of each table, since the number of possible sequences grows
+        //exponentially with the number of inputs
+        static constexpr size_t MAX_TABLE_SIZE = 1 << 20;
+
+        ///\returns true if sequences of num_inputs inputs with indicies up to max_input_idx can be cached
+        static bool can_cache(size_t num_inputs, size_t max_input_idx) { return num_inputs <= MAX_INPUTS && max_input_idx <= MAX_INPUT_IDX; }
+
+        ///\returns The key for the input sequence after appending input_idx with transition trans
+        static uint64_t append_key(uint64_t key, size_t input_idx, TransitionType trans) {
+            return (key << 6) | (input_idx << 2) | static_cast<uint64_t>(trans);
+        }
+
+        ///\returns The table of cached results for the function f
+        Table& function_table(const BDD& f);
+
+        ///Looks up the result for key in table
+        ///\returns A pointer to the cached result, or nullptr if not cached
+        static const Result* find(const Table& table, uint64_t key);
+
+        ///Adds a result to table (if there is room)
+        static void insert(Table& table, uint64_t key, const Result& result);
+
+        void clear() { function_tables_.clear(); }
+
+    private:
+        std::unordered_map<BDD,Table> function_tables_;
+};
@@ -0,0 +1,257 @@
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include "dddmp.h"
+
+#include "checkpoint.hpp"
+#include "CuddSharpSatFraction.h"
+
+//Identifies (and versions) the checkpoint format
+const char CHECKPOINT_MAGIC[8] = {'E', 'S', 'T', 'A', 'C', 'K', 'P', 'T'};
+const uint32_t CHECKPOINT_VERSION = 2;
+
+//The tolerance when comparing node function fingerprints
+const double NODE_FUNC_FINGERPRINT_TOLERANCE = 1e-12;
+
+static void write_u32(std::ostream& os, uint32_t val);
+static uint32_t read_u32(std::istream& is);
+static void write_string(std::ostream& os, const std::string& str);
+static std::string read_string(std::istream& is);
+static void write_double(std::ostream& os, double val);
+static double read_double(std::istream& is);
+static std::vector<double> node_func_fingerprints(const TimingGraph& tg);
+static void write_tags(std::ostream& os, const ExtTimingTags& tags);
+static ExtTimingTags read_tags(std::istream& is);
+
+std::string xfunc_filename(const std::string& checkpoint_filename) {
+    return checkpoint_filename + ".xfuncs.dddmp";
+}
+
+void write_checkpoint(const std::string& filename, const TimingGraph& tg, const AnalysisCheckpoint& checkpoint) {
+    std::string tmp_filename = filename + ".tmp";
+    std::ofstream os(tmp_filename, std::ios::binary);
+    if(!os) {
+        throw std::runtime_error("Failed to open checkpoint " + tmp_filename + " for writing");
+    }
+
+    os.write(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+    write_u32(os, CHECKPOINT_VERSION);
+
+    //Identifies the timing graph and tag layout the checkpoint is valid for
+    write_u32(os, tg.num_nodes());
+    write_u32(os, tg.num_edges());
+    write_u32(os, sizeof(ExtTimingTag));
+    write_u32(os, tg.num_levels());
+    for(double fingerprint : node_func_fingerprints(tg)) {
+        write_double(os, fingerprint);
+    }
+
+    write_u32(os, checkpoint.next_level);
+
+    g_scenario_store.write(os);
+
+    for(NodeId node_id = 0; node_id < tg.num_nodes(); ++node_id) {
+        write_tags(os, checkpoint.data_tags[node_id]);
+        write_tags(os, checkpoint.clock_tags[node_id]);
+    }
+
+    write_u32(os, checkpoint.cudd_var_order.size());
+    for(int var_idx : checkpoint.cudd_var_order) {
+        write_u32(os, var_idx);
+    }
+
+    write_u32(os, checkpoint.var_order.size());
+    for(const NamedInputVar& var : checkpoint.var_order) {
+        write_string(os, var.first);
+        write_string(os, var.second);
+    }
+
+    write_string(os, checkpoint.xfunc_config);
+    write_u32(os, checkpoint.xfunc_tags.size());
+    for(TagId tag_id : checkpoint.xfunc_tags) {
+        write_u32(os, tag_id);
+    }
+
+    os.close();
+    if(!os || std::rename(tmp_filename.c_str(), filename.c_str()) != 0) {
+        throw std::runtime_error("Failed to write checkpoint " + filename);
+    }
+
+    if(!checkpoint.xfuncs.empty()) {
+        assert(checkpoint.xfuncs.size() == checkpoint.xfunc_tags.size());
+
+        std::vector<DdNode*> roots;
+        for(const BDD& f : checkpoint.xfuncs) {
+            roots.push_back(f.getNode());
+        }
+
+        std::string xfuncs_filename = xfunc_filename(filename);
+        int result = Dddmp_cuddBddArrayStore(g_cudd.getManager(), nullptr, roots.size(), roots.data(), nullptr, nullptr, nullptr,
+                                             DDDMP_MODE_BINARY, DDDMP_VARIDS, const_cast<char*>(xfuncs_filename.c_str()), nullptr);
+        if(result != DDDMP_SUCCESS) {
+            throw std::runtime_error("Failed to write checkpoint xfuncs " + xfuncs_filename);
+        }
+    }
+}
+
+void read_checkpoint(const std::string& filename, const TimingGraph& tg, AnalysisCheckpoint& checkpoint) {
+    std::ifstream is(filename, std::ios::binary);
+    if(!is) {
+        throw std::runtime_error("Failed to open checkpoint " + filename);
+    }
+
+    char magic[sizeof(CHECKPOINT_MAGIC)];
+    is.read(magic, sizeof(magic));
+    if(!is || std::memcmp(magic, CHECKPOINT_MAGIC, sizeof(magic)) != 0 || read_u32(is) != CHECKPOINT_VERSION) {
+        throw std::runtime_error(filename + " is not a compatible checkpoint");
+    }
+
+    uint32_t num_nodes = read_u32(is);
+    uint32_t num_edges = read_u32(is);
+    uint32_t tag_size = read_u32(is);
+    uint32_t num_levels = read_u32(is);
+    if(num_nodes != size_t(tg.num_nodes()) || num_edges != size_t(tg.num_edges()) || num_levels != size_t(tg.num_levels())) {
+        throw std::runtime_error("Checkpoint " + filename + " was written for a different timing graph");
+    }
+    if(tag_size != sizeof(ExtTimingTag)) {
+        throw std::runtime_error("Checkpoint " + filename + " was written by an incompatible build");
+    }
+
+    for(double fingerprint : node_func_fingerprints(tg)) {
+        if(std::fabs(read_double(is) - fingerprint) > NODE_FUNC_FINGERPRINT_TOLERANCE) {
+            throw std::runtime_error("Checkpoint " + filename + " was written for different node functions");
+        }
+    }
+
+    checkpoint.next_level = read_u32(is);
+    if(checkpoint.next_level < 0 || checkpoint.next_level > LevelId(num_levels)) {
+        throw std::runtime_error("Checkpoint " + filename + " is corrupt");
+    }
+
+    g_scenario_store.read(is);
+
+    checkpoint.data_tags.clear();
+    checkpoint.clock_tags.clear();
+    for(NodeId node_id = 0; node_id < tg.num_nodes(); ++node_id) {
+        checkpoint.data_tags.push_back(read_tags(is));
+        checkpoint.clock_tags.push_back(read_tags(is));
+    }
+
+    checkpoint.cudd_var_order.resize(read_u32(is));
+    for(int& var_idx : checkpoint.cudd_var_order) {
+        var_idx = read_u32(is);
+    }
+
+    checkpoint.var_order.resize(read_u32(is));
+    for(NamedInputVar& var : checkpoint.var_order) {
+        var.first = read_string(is);
+        var.second = read_string(is);
+    }
+
+    checkpoint.xfunc_config = read_string(is);
+    checkpoint.xfunc_tags.resize(read_u32(is));
+    for(TagId& tag_id : checkpoint.xfunc_tags) {
+        tag_id = read_u32(is);
+        if(tag_id >= g_scenario_store.num_tags()) {
+            throw std::runtime_error("Checkpoint " + filename + " is corrupt");
+        }
+    }
+    checkpoint.xfuncs.clear();
+
+    if(!is) {
+        throw std::runtime_error("Failed to read checkpoint " + filename);
+    }
+}
+
+void read_checkpoint_xfuncs(const std::string& filename, AnalysisCheckpoint& checkpoint) {
+    checkpoint.xfuncs.clear();
+    if(checkpoint.xfunc_tags.empty()) return;
+
+    std::string xfuncs_filename = xfunc_filename(filename);
+
+    DdNode** roots = nullptr;
+    int num_roots = Dddmp_cuddBddArrayLoad(g_cudd.getManager(), DDDMP_ROOT_MATCHLIST, nullptr, DDDMP_VAR_MATCHIDS, nullptr, nullptr, nullptr,
+                                           DDDMP_MODE_BINARY, const_cast<char*>(xfuncs_filename.c_str()), nullptr, &roots);
+    if(num_roots <= 0 || !roots) {
+        throw std::runtime_error("Failed to read checkpoint xfuncs " + xfuncs_filename);
+    }
+
+    //The loaded roots are referenced, so hand the references over to BDD objects
+    for(int i = 0; i < num_roots; ++i) {
+        checkpoint.xfuncs.push_back(BDD(g_cudd, roots[i]));
+        Cudd_RecursiveDeref(g_cudd.getManager(), roots[i]);
+    }
+    free(roots);
+
+    if(checkpoint.xfuncs.size() != checkpoint.xfunc_tags.size()) {
+        checkpoint.xfuncs.clear();
+        throw std::runtime_error("Checkpoint xfuncs " + xfuncs_filename + " do not match the checkpoint");
+    }
+}
+
+static void write_u32(std::ostream& os, uint32_t val) {
+    os.write(reinterpret_cast<const char*>(&val), sizeof(val));
+}
+
+static uint32_t read_u32(std::istream& is) {
+    uint32_t val = 0;
+    is.read(reinterpret_cast<char*>(&val), sizeof(val));
+    return val;
+}
+
+static void write_string(std::ostream& os, const std::string& str) {
+    write_u32(os, str.size());
+    os.write(str.data(), str.size());
+}
+
+static std::string read_string(std::istream& is) {
+    std::string str(read_u32(is), '\0');
+    is.read(&str[0], str.size());
+    return str;
+}
+
+static void write_double(std::ostream& os, double val) {
+    os.write(reinterpret_cast<const char*>(&val), sizeof(val));
+}
+
+static double read_double(std::istream& is) {
+    double val = 0.;
+    is.read(reinterpret_cast<char*>(&val), sizeof(val));
+    return val;
+}
+
+static std::vector<double> node_func_fingerprints(const TimingGraph& tg) {
+    //The fraction of satisfying minterms does not depend on the variable order
+    //or the number of variables in the manager
+    std::vector<DdNode*> node_funcs;
+    for(NodeId node_id = 0; node_id < tg.num_nodes(); ++node_id) {
+        node_funcs.push_back(tg.node_func(node_id).getNode());
+    }
+    return CountMintermFractions(node_funcs);
+}
+
+static void write_tags(std::ostream& os, const ExtTimingTags& tags) {
+    write_u32(os, tags.num_tags());
+    for(ExtTimingTag::cptr tag : tags) {
+        write_u32(os, tag->id());
+    }
+}
+
+static ExtTimingTags read_tags(std::istream& is) {
+    ExtTimingTags tags;
+
+    uint32_t num_tags = read_u32(is);
+    for(uint32_t i = 0; is && i < num_tags; ++i) {
+        TagId tag_id = read_u32(is);
+        if(tag_id >= g_scenario_store.num_tags()) {
+            throw std::runtime_error("Checkpoint tag id out of range");
+        }
+        tags.add_tag(g_scenario_store.tag(tag_id));
+    }
+    return tags;
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <string>
+#include <vector>
+
+#include "bdd.hpp"
+#include "TimingGraph.hpp"
+#include "ExtTimingTags.hpp"
+#include "var_order.hpp"
+
+/*
+ * A checkpoint of the results of an ESTA analysis, so that the outputs can be (re-)generated
+ * without re-analyzing the circuit.
+ *
+ * A checkpoint may also be taken part way through the forward traversal (after a level completes),
+ * in which case only the nodes in the completed levels have tags, and the analysis can be resumed
+ * from the next level (see SerialTimingAnalyzer::resume_timing()).  The node functions are rebuilt
+ * from the netlist, so are only fingerprinted to check they match, while g_cudd's variable order
+ * is recorded so the resumed traversal evaluates them in the same order.
+ *
+ * The checkpoint records the tags of each node along with all the tags and switching scenarios
+ * in g_scenario_store (i.e. the tag DAG), and the primary input variable order.  Optionally it
+ * also records the xfuncs of some tags, so they need not be rebuilt.
+ *
+ * The tags are written in a binary format, which is only valid for the same timing graph and
+ * build of the tool.  The xfuncs are written with DDDMP to a separate file (see xfunc_filename()),
+ * and are only valid for the same condition functions.
+ */
+struct AnalysisCheckpoint {
+    LevelId next_level = 0; //The first level of the forward traversal not yet evaluated (tg.num_levels() if complete)
+    std::vector<ExtTimingTags> data_tags; //Of each node
+    std::vector<ExtTimingTags> clock_tags; //Of each node
+
+    std::vector<int> cudd_var_order; //g_cudd's variable order when written (see manager_var_order())
+
+    std::vector<NamedInputVar> var_order; //Primary input variable order (top to bottom)
+
+    std::string xfunc_config; //Identifies the condition functions the xfuncs were built with
+    std::vector<TagId> xfunc_tags; //Tags with saved xfuncs
+    std::vector<BDD> xfuncs; //The saved xfuncs, indexed as xfunc_tags
+};
+
+///\returns The name of the file holding a checkpoint's xfuncs
+std::string xfunc_filename(const std::string& checkpoint_filename);
+
+///Writes a checkpoint (and its xfuncs, if any).
+///The tags and scenarios are written from g_scenario_store.
+///The checkpoint is first written to a temporary file, so an interrupted write leaves any
+///previous checkpoint intact.
+void write_checkpoint(const std::string& filename, const TimingGraph& tg, const AnalysisCheckpoint& checkpoint);
+
+///Reads a checkpoint (except its xfuncs, see read_checkpoint_xfuncs()), replacing the contents of g_scenario_store
+///\throws std::runtime_error if the checkpoint is invalid or was written for a different timing graph
+///       (or node functions)
+void read_checkpoint(const std::string& filename, const TimingGraph& tg, AnalysisCheckpoint& checkpoint);
+
+///Reads the xfuncs of a checkpoint into g_cudd.
+///The variables must have been created with the same indicies as when the xfuncs were written.
+///\throws std::runtime_error if the xfuncs can not be read
+void read_checkpoint_xfuncs(const std::string& filename, AnalysisCheckpoint& checkpoint);
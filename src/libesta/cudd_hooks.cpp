@@ -1,9 +1,13 @@
 #include "cudd_hooks.hpp"
 #include "util.h" //From CUDD
+#include "CuddSharpSatFraction.h"
+#include "ReorderScheduler.hpp"
 
 int PreReorderHook( DdManager* dd, const char* str, void* /*data*/) {
     int retval;
 
+    g_reorder_scheduler.begin_reorder(dd);
+
     retval = fprintf(dd->out,"%s reordering", str);
     if (retval == EOF) return(0);
 
@@ -25,10 +29,15 @@ int PostReorderHook( DdManager *dd, const char *str, void *data) {
 
     retval = fprintf(dd->out,"%ld nodes in %g sec", node_cnt,
 		     totalTimeSec);
-    //Override default reorder size to be factor of two
-    auto next_reorder = std::max(2*node_cnt, (long) 4096) + dd->constants.keys;
-    Cudd_SetNextReordering(dd, next_reorder);
-    retval = fprintf(dd->out," (next reorder %u nodes)\n", dd->nextDyn - dd->constants.keys);
+    //Let the scheduler pick the next reorder size (or method) based on how productive this one was
+    g_reorder_scheduler.end_reorder(dd, finalTime - initialTime);
+    if(g_reorder_scheduler.enabled()) {
+        retval = fprintf(dd->out," (next reorder %u nodes)\n", dd->nextDyn - dd->constants.keys);
+    } else if(g_reorder_scheduler.paused()) {
+        retval = fprintf(dd->out," (reordering paused, over time budget)\n");
+    } else {
+        retval = fprintf(dd->out," (reordering disabled)\n");
+    }
     if (retval == EOF) return(0);
     retval = fflush(dd->out);
     if (retval == EOF) return(0);
@@ -45,3 +54,8 @@ int PostGarbageCollectHook(DdManager* dd, const char* /*str*/, void* /*data*/) {
     return 1;
 }
 
+
+int ClearMintermFractionMemoHook(DdManager* /*dd*/, const char* /*str*/, void* /*data*/) {
+    ClearMintermFractionMemo();
+    return 1;
+}
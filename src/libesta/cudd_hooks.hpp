@@ -2,7 +2,14 @@
 #include "cuddObj.hh"
 #include "cuddInt.h"
 
+//Report each reordering, and schedule the next one with g_reorder_scheduler.
+//Must be installed as a CUDD_PRE_REORDERING_HOOK and CUDD_POST_REORDERING_HOOK respectively
 int PreReorderHook( DdManager *dd, const char *str, void *data);
 int PostReorderHook( DdManager *dd, const char *str, void *data);
 int PreGarbageCollectHook(DdManager* dd, const char* str, void* data);
 int PostGarbageCollectHook(DdManager* dd, const char* str, void* data);
+
+//Clears the persistent minterm fraction memo (see CountMintermFraction()).
+//Must be installed as both a CUDD_PRE_GC_HOOK and CUDD_PRE_REORDERING_HOOK on any manager whose
+//nodes are counted, since nodes may be freed (and their addresses re-used) by either
+int ClearMintermFractionMemoHook(DdManager* dd, const char* str, void* data);
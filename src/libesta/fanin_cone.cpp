@@ -0,0 +1,63 @@
+#include <cassert>
+
+#include "fanin_cone.hpp"
+
+void extract_fanin_cone(const TimingGraph& tg, const std::vector<NodeId>& root_nodes,
+                        TimingGraph& cone_tg, std::vector<NodeId>& cone_to_orig_nodes, std::vector<EdgeId>& cone_to_orig_edges) {
+    assert(cone_tg.num_nodes() == 0);
+
+    //Mark the cone by walking backward from the roots
+    std::vector<bool> in_cone(tg.num_nodes(), false);
+    std::vector<NodeId> stack;
+    for(NodeId node_id : root_nodes) {
+        if(!in_cone[node_id]) {
+            in_cone[node_id] = true;
+            stack.push_back(node_id);
+        }
+    }
+    while(!stack.empty()) {
+        NodeId node_id = stack.back();
+        stack.pop_back();
+
+        for(int edge_idx = 0; edge_idx < tg.num_node_in_edges(node_id); ++edge_idx) {
+            NodeId src_node_id = tg.edge_src_node(tg.node_in_edge(node_id, edge_idx));
+            if(!in_cone[src_node_id]) {
+                in_cone[src_node_id] = true;
+                stack.push_back(src_node_id);
+            }
+        }
+    }
+
+    //Copy the cone nodes, in their original relative order
+    std::vector<NodeId> orig_to_cone_nodes(tg.num_nodes(), -1);
+    cone_to_orig_nodes.clear();
+    for(NodeId orig_node_id = 0; orig_node_id < tg.num_nodes(); ++orig_node_id) {
+        if(!in_cone[orig_node_id]) continue;
+
+        NodeId node_id = cone_tg.add_node(tg.node_type(orig_node_id), tg.node_clock_domain(orig_node_id), tg.node_is_clock_source(orig_node_id));
+        cone_tg.set_node_func(node_id, tg.node_func(orig_node_id));
+        if(tg.node_has_truth_table(orig_node_id)) {
+            cone_tg.set_node_truth_table(node_id, tg.node_truth_table(orig_node_id));
+        }
+
+        orig_to_cone_nodes[orig_node_id] = node_id;
+        cone_to_orig_nodes.push_back(orig_node_id);
+    }
+
+    //Copy the edges between cone nodes.
+    //Since the cone is closed under fanin, this is exactly the cone nodes' in-edges,
+    //which are added in ascending edge order so each node's input ordering is preserved
+    cone_to_orig_edges.clear();
+    for(EdgeId orig_edge_id = 0; orig_edge_id < tg.num_edges(); ++orig_edge_id) {
+        NodeId orig_sink_node_id = tg.edge_sink_node(orig_edge_id);
+        if(!in_cone[orig_sink_node_id]) continue;
+
+        NodeId orig_src_node_id = tg.edge_src_node(orig_edge_id);
+        assert(in_cone[orig_src_node_id]);
+
+        cone_tg.add_edge(orig_to_cone_nodes[orig_src_node_id], orig_to_cone_nodes[orig_sink_node_id]);
+        cone_to_orig_edges.push_back(orig_edge_id);
+    }
+
+    cone_tg.levelize();
+}
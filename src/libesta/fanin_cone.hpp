@@ -0,0 +1,42 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "TimingGraph.hpp"
+#include "TimingGraphNameResolver.hpp"
+
+///Extracts the transitive fanin cone of a set of nodes as a new (levelized) timing graph.
+///
+///Only the nodes (and edges) which can reach one of the root nodes are copied, so a
+///timing analysis (and BDD variable allocation) on the cone only pays for the primary
+///inputs which actually affect the roots.
+///
+///Node functions and truth tables are copied unchanged; they remain valid since every
+///fanin edge of a cone node is also in the cone, and edges are added in their original
+///order (preserving each node's input ordering).
+///
+///\param tg The full timing graph
+///\param root_nodes The nodes whose fanin cone should be extracted
+///\param cone_tg The timing graph to build the cone in (should be empty)
+///\param cone_to_orig_nodes Filled with the original node id of each cone node
+///\param cone_to_orig_edges Filled with the original edge id of each cone edge
+void extract_fanin_cone(const TimingGraph& tg, const std::vector<NodeId>& root_nodes,
+                        TimingGraph& cone_tg, std::vector<NodeId>& cone_to_orig_nodes, std::vector<EdgeId>& cone_to_orig_edges);
+
+//Resolves the names of a fanin cone's nodes using the name resolver of the original timing graph
+class TimingGraphConeNameResolver : public TimingGraphNameResolver {
+    public:
+        TimingGraphConeNameResolver(std::shared_ptr<TimingGraphNameResolver> orig_name_resolver, std::vector<NodeId> cone_to_orig_nodes)
+            : orig_name_resolver_(orig_name_resolver)
+            , cone_to_orig_nodes_(cone_to_orig_nodes)
+            {}
+
+        std::string get_node_name(NodeId node_id) {
+            return orig_name_resolver_->get_node_name(cone_to_orig_nodes_[node_id]);
+        }
+
+    private:
+        std::shared_ptr<TimingGraphNameResolver> orig_name_resolver_;
+        std::vector<NodeId> cone_to_orig_nodes_;
+};
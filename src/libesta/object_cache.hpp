@@ -1,16 +1,34 @@
 #ifndef OBJECT_CACHE_HPP
 #define OBJECT_CACHE_HPP
 
-#include <list>
-#include <map>
-#include <tuple>
-
-
-template <
-    typename K, //The type of the key indexing the cache
-    typename V, //The type of the value being stored in the cache
-    template<typename ...> class MAP  //The map type
-    >
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * A fixed capacity cache, which evicts the entries which are cheapest to rebuild.
+ *
+ * Each entry is inserted with its rebuild cost (e.g. the size of a BDD, or the time taken
+ * to build it).  Eviction follows the GreedyDual policy: each entry has a credit of
+ * (inflation + cost), refreshed on every hit, and the entry with the lowest credit is
+ * evicted (raising the inflation to its credit, so entries which are not used age
+ * relative to new ones).  With uniform costs this degenerates to (approximate) LRU.
+ *
+ * Rather than keeping entries sorted by credit, the lowest credit is approximated with
+ * a CLOCK sweep over the entry slots: the hand evicts the first entry whose credit has
+ * fallen to the inflation, raising the inflation to the lowest credit seen if it completes
+ * a full revolution without finding one.  As in CLOCK, an entry which has been used since
+ * the hand last passed it gets a second chance (its credit is renewed) instead.
+ *
+ * Keys are indexed by a hash map (to their slots), so find(), insert() and erase() are O(1)
+ * (amortized for eviction), and find() reports both hit/miss and the value in a single lookup.
+ *
+ * Not thread-safe; see ShardedObjectCache for concurrent use.
+ */
+template<typename K, typename V, typename Hash=std::hash<K>>
 class ObjectCache {
     public:
         //The key type used to index the cache
@@ -19,28 +37,16 @@ class ObjectCache {
         //The value type of the thing we are caching
         typedef V value_t;
 
-        //Stores the most recently accesed elements
-        typedef std::list<key_t> key_order_t;
-
-        //Could use something like a splay tree here, so commonly accessed
-        //objects are fastest - or a Hash/unordered_map
-        typedef MAP<
-            key_t, 
-            std::pair<
-                value_t, //The actual value
-                typename key_order_t::iterator //The iterator that marks this values position in the order of accesses
-            > 
-        > obj_cache_t;
-
         //Constructor
         //  'capacity' of zero means no size limit
-        //  'allow_key_overwrites' determines whether an exception is 
-        //    thrown if keys are overwritten
         //  'print_stats' prints hit/miss/capacity statistics on destruction
-        ObjectCache(size_t capacity_val = 0, bool allow_key_overwrites = false, bool print_stats_val = true) 
+        ObjectCache(size_t capacity_val = 0, bool print_stats_val = true)
             : capacity_(capacity_val)
-            , allow_key_overwrites_(allow_key_overwrites)
+            , cost_capacity_(0.)
+            , total_cost_(0.)
             , print_stats_(print_stats_val)
+            , hand_(0)
+            , inflation_(0.)
             , num_hits_(0)
             , num_misses_(0)
             , num_evictions_(0) {}
@@ -48,69 +54,168 @@ class ObjectCache {
         //Destructor
         ~ObjectCache();
 
-        //Inserts the given key and value into the case, evicting an item
-        //if it is already at capacity
-        value_t& insert(const key_t& key, const value_t& value);
+        //Looks up the key, refreshing its credit if found
+        //  Returns a pointer to the value, or nullptr if the key is not in the cache.
+        //  The pointer is valid until the cache is next modified
+        value_t* find(const key_t& key);
 
-        //Query to see if a value is in the cache
-        bool contains(const key_t& key);
+        //Inserts (or overwrites) the given key and value into the cache, with the
+        //specified rebuild cost, evicting an item if it is already at capacity
+        value_t& insert(const key_t& key, const value_t& value, double cost = 1.);
 
-        //Access a value in the cache.  Throws an exception if the key does not
-        //exist in the cache
-        value_t& value(const key_t& key);
+        //Removes the key (and its value) from the cache.
+        //Returns true if the key was in the cache
+        bool erase(const key_t& key);
 
-        size_t capacity() { return capacity_; }
+        size_t size() const { return index_.size(); }
+
+        size_t capacity() const { return capacity_; }
         void set_capacity(size_t val) { capacity_ = val; resize(); }
 
-        void clear() { object_lookup_.clear(); key_access_order_.clear(); }
+        //The total cost of the entries the cache can hold (e.g. a budget of BDD nodes)
+        //  zero means no limit
+        double cost_capacity() const { return cost_capacity_; }
+        void set_cost_capacity(double val) { cost_capacity_ = val; resize(); }
 
-        void reset_stats() { num_hits_ = 0; num_misses_ = 0; num_evictions_ = 0; }
+        //The total cost of the entries in the cache
+        double total_cost() const { return total_cost_; }
 
-        void print_stats();
+        //Evicts entries until the total cost is at most target_cost
+        void evict_to_cost(double target_cost);
 
-    private:
+        void clear();
 
-        //Moves the key specified by this iterator to the front of the key access list
-        // i.e. to be Most Recently Used (MRU)
-        void set_most_recently_used(typename key_order_t::iterator it);
+        void reset_stats() { num_hits_ = 0; num_misses_ = 0; num_evictions_ = 0; }
+
+        void print_stats() const;
 
-        //Evicts and element from the cache
+    private:
+        struct Entry {
+            key_t key;
+            value_t value;
+            double cost;
+            double credit;
+            bool referenced; //Used since the hand last passed
+            bool occupied;
+        };
+
+        //Evicts an element from the cache
         void evict();
 
+        //Frees the slot of an evicted/erased entry
+        void free_slot(size_t slot);
+
         void resize();
 
-        //The actual cache mapping key_t objects to value_t
-        obj_cache_t object_lookup_;
+    private:
+        //The slot of each key's entry in entries_
+        std::unordered_map<key_t,size_t,Hash> index_;
 
-        //What order the keys have been accessed in
-        // MRU at the head, LRU at the tail
-        key_order_t key_access_order_;
+        //The entries, and the slots which are unoccupied
+        std::vector<Entry> entries_;
+        std::vector<size_t> free_slots_;
 
         //How many items the cache can hold
         size_t capacity_;
 
-        //Whether we error if a key is over-written
-        bool allow_key_overwrites_;
+        //The total cost of items the cache can hold, and of those it holds
+        double cost_capacity_;
+        double total_cost_;
 
         //Should we print statistics on destruction?
         bool print_stats_;
 
+        //Eviction state
+        size_t hand_; //The current CLOCK position in entries_
+        double inflation_; //Credits at or below this are eligible for eviction
+
         //Cache statistics
         size_t num_hits_; //Number of times a value was found in the cache
 
         size_t num_misses_; //Number of time a value was NOT found in the cache
 
         size_t num_evictions_;
+};
 
+/*
+ * An ObjectCache split into independently locked shards (by key hash), so it may be shared
+ * by multiple threads with little contention.  The capacity is divided evenly between the shards.
+ *
+ * Values are returned by copy, since a reference could be invalidated by another thread.
+ */
+template<typename K, typename V, typename Hash=std::hash<K>>
+class ShardedObjectCache {
+    public:
+        typedef K key_t;
+        typedef V value_t;
+
+        ShardedObjectCache(size_t num_shards, size_t capacity_val = 0)
+            : shards_(num_shards)
+            , hash_() {
+            for(auto& shard : shards_) {
+                shard.reset(new Shard(shard_capacity(capacity_val)));
+            }
+        }
+
+        //Looks up the key, copying its value to 'value' if found
+        //  Returns true if the key was found
+        bool find(const key_t& key, value_t& value) {
+            Shard& shard = shard_for(key);
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            value_t* found = shard.cache.find(key);
+            if(found) {
+                value = *found;
+            }
+            return found != nullptr;
+        }
+
+        void insert(const key_t& key, const value_t& value, double cost = 1.) {
+            Shard& shard = shard_for(key);
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.cache.insert(key, value, cost);
+        }
+
+        bool erase(const key_t& key) {
+            Shard& shard = shard_for(key);
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            return shard.cache.erase(key);
+        }
+
+        void set_capacity(size_t val) {
+            for(auto& shard : shards_) {
+                std::lock_guard<std::mutex> lock(shard->mutex);
+                shard->cache.set_capacity(shard_capacity(val));
+            }
+        }
+
+        void clear() {
+            for(auto& shard : shards_) {
+                std::lock_guard<std::mutex> lock(shard->mutex);
+                shard->cache.clear();
+            }
+        }
+
+    private:
+        struct Shard {
+            Shard(size_t capacity_val) : cache(capacity_val, false) {}
+
+            std::mutex mutex;
+            ObjectCache<K,V,Hash> cache;
+        };
+
+        Shard& shard_for(const key_t& key) { return *shards_[hash_(key) % shards_.size()]; }
+
+        size_t shard_capacity(size_t capacity_val) const {
+            if(capacity_val == 0) return 0; //Unlimited
+            return (capacity_val + shards_.size() - 1) / shards_.size();
+        }
+
+    private:
+        std::vector<std::unique_ptr<Shard>> shards_;
+        Hash hash_;
 };
 
 //For template definitions
 #include "object_cache.tpp"
 
-template<typename K, typename V>
-using ObjectCacheMap = ObjectCache<K, V, std::map>;
-
-template<typename K, typename V>
-using ObjectCacheUnorderedMap = ObjectCache<K, V, std::unordered_map>;
-
 #endif
@@ -1,105 +1,115 @@
 #ifndef OBJECT_CACHE_TPP
 #define OBJECT_CACHE_TPP
 
+#include <algorithm>
 #include <iostream>
+#include <limits>
 #include <cassert>
 
 /*
  * Public methods
  */
-template<typename K, typename V, template<typename ...> class MAP>
-ObjectCache<K,V,MAP>::~ObjectCache() {
+template<typename K, typename V, typename Hash>
+ObjectCache<K,V,Hash>::~ObjectCache() {
     if(print_stats_) {
         print_stats();
     }
 }
 
-//Add an value to the cache for the specified key, evicting the LRU if neccessary
-template<typename K, typename V, template<typename ...> class MAP>
-typename ObjectCache<K,V,MAP>::value_t& ObjectCache<K,V,MAP>::insert(const key_t& key, const value_t& new_value) {
-    if(!allow_key_overwrites_ && object_lookup_.count(key)) {
-        throw std::runtime_error("Attempted to overwrite key in cache!");
+template<typename K, typename V, typename Hash>
+typename ObjectCache<K,V,Hash>::value_t* ObjectCache<K,V,Hash>::find(const key_t& key) {
+    auto iter = index_.find(key);
+    if(iter == index_.end()) {
+        num_misses_++;
+        return nullptr;
     }
+    num_hits_++;
+
+    //Refresh the entry's credit
+    Entry& entry = entries_[iter->second];
+    entry.credit = inflation_ + entry.cost;
+    entry.referenced = true;
 
+    return &entry.value;
+}
 
-    if(capacity_ > 0 && object_lookup_.size() == capacity_) {
-        //Delete an item from the cache 
+//Add an value to the cache for the specified key, evicting if neccessary
+template<typename K, typename V, typename Hash>
+typename ObjectCache<K,V,Hash>::value_t& ObjectCache<K,V,Hash>::insert(const key_t& key, const value_t& new_value, double cost) {
+    auto iter = index_.find(key);
+    if(iter != index_.end()) {
+        //Overwrite
+        Entry& entry = entries_[iter->second];
+        entry.value = new_value;
+        total_cost_ += cost - entry.cost;
+        entry.cost = cost;
+        entry.credit = inflation_ + cost;
+        entry.referenced = true;
+        return entry.value;
+    }
+
+    if(capacity_ > 0 && index_.size() >= capacity_) {
+        //Delete an item from the cache
         evict();
     }
 
     //Verify that there is space
-    assert(capacity_ == 0 || object_lookup_.size() < capacity_);
-
-    if(allow_key_overwrites_) {
-        //We need to move the key to the front if it is already in the access order list
-        auto iter = object_lookup_.find(key);
-        if(iter != object_lookup_.end()) {
-            //Object already exists
-            //Set is as MRU
-            set_most_recently_used(iter->second.second); //The iterator in the access list
-
-            assert(*(key_access_order_.begin()) == key);
-
-            //Add the updated element
-            object_lookup_[key] = {new_value, key_access_order_.begin()};
-        } else {
-            //First time seen, normal insert
-            key_access_order_.push_front(key);
-
-            //Add to the cache and return a refernce to it from the cache
-            object_lookup_[key] = {new_value, key_access_order_.begin()};
-        }
-
-    } else {
-        //Keys are uniquely added, so we can just push it onto the beginning
-        //of the list as the most recently accessed item
-        key_access_order_.push_front(key);
+    assert(capacity_ == 0 || index_.size() < capacity_);
 
-        //Add to the cache and return a refernce to it from the cache
-        object_lookup_[key] = {new_value, key_access_order_.begin()};
+    if(cost_capacity_ > 0.) {
+        //Make room for the new entry's cost (an entry costing more than the capacity is still cached,
+        //but will be the only entry)
+        evict_to_cost(cost_capacity_ - cost);
     }
 
-    //The map and key list should always bee the same size
-    // Note that the std::list used for key_access_order_ should keep
-    // track of the list size, so the size() query is O(1) when run in C++11
-    // mode, BUT gcc is non-conformant in this respect, making size() O(N)
-    // so only use this for debugging
-    //assert(key_access_order_.size() == object_lookup_.size());
+    size_t slot;
+    if(!free_slots_.empty()) {
+        slot = free_slots_.back();
+        free_slots_.pop_back();
+        entries_[slot] = {key, new_value, cost, inflation_ + cost, false, true};
+    } else {
+        slot = entries_.size();
+        entries_.push_back({key, new_value, cost, inflation_ + cost, false, true});
+    }
+    index_[key] = slot;
+    total_cost_ += cost;
 
-    return value(key);
+    return entries_[slot].value;
 }
 
-
-//Check whether the object is caching the given key
-template<typename K, typename V, template<typename ...> class MAP>
-bool ObjectCache<K,V,MAP>::contains(const key_t& key) {
-    bool val =  object_lookup_.count(key);
-
-    //Record stats
-    if(val) {
-        num_hits_++;
-    } else {
-        num_misses_++;
+//Removes the given key from the cache
+template<typename K, typename V, typename Hash>
+bool ObjectCache<K,V,Hash>::erase(const key_t& key) {
+    auto iter = index_.find(key);
+    if(iter == index_.end()) {
+        return false;
     }
 
-    return val;
+    size_t slot = iter->second;
+    index_.erase(iter);
+    free_slot(slot);
+    return true;
 }
 
-//Returns the value associated with the given key
-// Raises an exception if the key is not found
-template<typename K, typename V, template<typename ...> class MAP>
-typename ObjectCache<K,V,MAP>::value_t& ObjectCache<K,V,MAP>::value(const key_t& key) {
-    auto iter = object_lookup_.find(key);
-    if(iter == object_lookup_.end()) {
-        throw std::runtime_error("Could not find key in object cache!");
+template<typename K, typename V, typename Hash>
+void ObjectCache<K,V,Hash>::evict_to_cost(double target_cost) {
+    while(!index_.empty() && total_cost_ > target_cost) {
+        evict();
     }
-    //Second is the 'value' of the map
-    //First is the actual stored value, not the LRU list iterator
-    return iter->second.first;
 }
 
-template<typename K, typename V, template<typename ...> class MAP>
-void ObjectCache<K,V,MAP>::print_stats() {
+template<typename K, typename V, typename Hash>
+void ObjectCache<K,V,Hash>::clear() {
+    index_.clear();
+    entries_.clear();
+    free_slots_.clear();
+    hand_ = 0;
+    inflation_ = 0.;
+    total_cost_ = 0.;
+}
+
+template<typename K, typename V, typename Hash>
+void ObjectCache<K,V,Hash>::print_stats() const {
     std::cout << "Cache Statistics:" << std::endl;
     std::cout << "  Hits         : " << num_hits_ << std::endl;
     std::cout << "  Misses       : " << num_misses_ << std::endl;
@@ -108,46 +118,75 @@ void ObjectCache<K,V,MAP>::print_stats() {
     std::cout << "  Hit Rate     : " << ((float) num_hits_) / (num_misses_ + num_hits_) << std::endl;
     std::cout << "  Eviction Rate: " << ((float) num_evictions_) / (num_misses_ + num_hits_) << std::endl;
     std::cout << "  Target Capacity (# items): " << capacity_ << std::endl;
-    std::cout << "  Actual Size (# items)    : " << object_lookup_.size() << std::endl;
+    std::cout << "  Actual Size (# items)    : " << index_.size() << std::endl;
+    if(cost_capacity_ > 0.) {
+        std::cout << "  Target Capacity (cost)   : " << cost_capacity_ << std::endl;
+    }
+    std::cout << "  Actual Size (cost)       : " << total_cost_ << std::endl;
 }
 
 /*
  * Private methods
  */
 
+//Evicts an element based on the GreedyDual policy (approximated by a CLOCK sweep)
+template<typename K, typename V, typename Hash>
+void ObjectCache<K,V,Hash>::evict() {
+    assert(index_.size() > 0);
 
-//Make the key associated with the iterator the Most Recently Used.
-// (i.e. move it to the head of the list)
-template<typename K, typename V, template<typename ...> class MAP>
-void ObjectCache<K,V,MAP>::set_most_recently_used(typename key_order_t::iterator it) {
-    key_access_order_.push_front(*it); //Re-insert at the front
-    key_access_order_.erase(it); //Remove from old position
-}
-
-
-//Evicts an element based on an LRU policy
-template<typename K, typename V, template<typename ...> class MAP>
-void ObjectCache<K,V,MAP>::evict() {
-    //Use an LRU policy. The tail of key_access_order_ is the
-    //least recently used
-    assert(object_lookup_.size() > 0);
-
-    //Remove the key from the cache
-    size_t num_erased = object_lookup_.erase(key_access_order_.back());
+    double min_credit = std::numeric_limits<double>::infinity();
+    size_t num_visited = 0;
+    while(true) {
+        if(hand_ >= entries_.size()) {
+            hand_ = 0;
+        }
 
-    assert(num_erased == 1);
+        Entry& entry = entries_[hand_];
+        if(entry.occupied) {
+            if(entry.credit <= inflation_) {
+                if(!entry.referenced) {
+                    //Victim found
+                    index_.erase(entry.key);
+                    free_slot(hand_);
+                    ++hand_;
+                    num_evictions_++;
+                    return;
+                }
+
+                //Used since its credit was last refreshed, give it a second chance
+                entry.referenced = false;
+                entry.credit = inflation_ + entry.cost;
+            }
+            min_credit = std::min(min_credit, entry.credit);
+        }
+        ++hand_;
 
-    //Remove the key from the access order list - it will be the last entry
-    key_access_order_.erase(--(key_access_order_.end()));
+        if(++num_visited == entries_.size()) {
+            //Full revolution without a victim, age everything to the lowest credit seen
+            inflation_ = min_credit;
+            min_credit = std::numeric_limits<double>::infinity();
+            num_visited = 0;
+        }
+    }
+}
 
-    num_evictions_++;
+template<typename K, typename V, typename Hash>
+void ObjectCache<K,V,Hash>::free_slot(size_t slot) {
+    Entry& entry = entries_[slot];
+    total_cost_ -= entry.cost;
+    entry.occupied = false;
+    entry.value = value_t(); //Release the value's resources now, rather than when the slot is re-used
+    free_slots_.push_back(slot);
 }
 
 //Adjusts the cache size to match capacity
-template<typename K, typename V, template<typename ...> class MAP>
-void ObjectCache<K,V,MAP>::resize() {
-    while(object_lookup_.size() > capacity_) {
+template<typename K, typename V, typename Hash>
+void ObjectCache<K,V,Hash>::resize() {
+    while(capacity_ > 0 && index_.size() > capacity_) {
         evict();
     }
+    if(cost_capacity_ > 0.) {
+        evict_to_cost(cost_capacity_);
+    }
 }
 #endif
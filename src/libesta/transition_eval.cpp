@@ -82,6 +82,41 @@ TransitionType evaluate_output_transition(const std::vector<TransitionType>& inp
     }
 }
 
+TransitionType evaluate_output_transition(const std::vector<TransitionType>& input_transitions, TruthTable f) {
+    //Build the initial and final minterms (bit i is the value of input i)
+    assert(input_transitions.size() <= TRUTH_TABLE_MAX_VARS);
+    size_t initial_minterm = 0;
+    size_t final_minterm = 0;
+    for(size_t var_idx = 0; var_idx < input_transitions.size(); var_idx++) {
+        switch(input_transitions[var_idx]) {
+            case TransitionType::RISE:
+                final_minterm |= (size_t(1) << var_idx);
+                break;
+            case TransitionType::FALL:
+                initial_minterm |= (size_t(1) << var_idx);
+                break;
+            case TransitionType::HIGH:
+                initial_minterm |= (size_t(1) << var_idx);
+                final_minterm |= (size_t(1) << var_idx);
+                break;
+            case TransitionType::LOW:
+                break;
+
+            default:
+                assert(0);
+        }
+    }
+
+    bool init_output = tt_eval(f, initial_minterm);
+    bool final_output = tt_eval(f, final_minterm);
+
+    if(init_output) {
+        return (final_output) ? TransitionType::HIGH : TransitionType::FALL;
+    } else {
+        return (final_output) ? TransitionType::RISE : TransitionType::LOW;
+    }
+}
+
 TransitionType evaluate_output_transition(const std::vector<std::shared_ptr<const ExtTimingTag>>& input_tags_scenario, BDD f) {
     std::vector<TransitionType> input_transitions;
     for(auto tag : input_tags_scenario) {
@@ -0,0 +1,31 @@
+#include <vector>
+#include <algorithm>
+
+#include "cuddObj.hh"
+
+#include "truth_table.hpp"
+
+bool bdd_to_truth_table(const BDD& f, TruthTable& tt) {
+    auto support_indicies = f.SupportIndices();
+    for(auto var_idx : support_indicies) {
+        if(var_idx >= TRUTH_TABLE_MAX_VARS) {
+            return false;
+        }
+    }
+
+    //Evaluate f for each minterm
+    std::vector<int> inputs(TRUTH_TABLE_MAX_VARS, 0);
+    TruthTable result = 0;
+    for(size_t minterm = 0; minterm < (size_t(1) << TRUTH_TABLE_MAX_VARS); ++minterm) {
+        for(size_t var_idx = 0; var_idx < TRUTH_TABLE_MAX_VARS; ++var_idx) {
+            inputs[var_idx] = (minterm >> var_idx) & 1;
+        }
+
+        if(f.Eval(inputs.data()).IsOne()) {
+            result |= (TruthTable(1) << minterm);
+        }
+    }
+
+    tt = result;
+    return true;
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+#include "TransitionType.hpp"
+
+class BDD;
+
+/*
+ * Truth tables for logic functions of up to 6 variables, stored as a 64-bit word.
+ *
+ * Bit m of the table holds the function value for the minterm m, where bit i of m is
+ * the value of variable i.  Functions of fewer than 6 variables do not depend on the
+ * higher variables, so their tables are simply replicated (e.g. the constant functions
+ * are always all zeros or all ones).
+ *
+ * Restriction, cofactor comparisons and evaluation are then a handful of bit operations,
+ * rather than operations on the BDD package.
+ */
+typedef uint64_t TruthTable;
+
+//The maximum number of variables which can be represented in a truth table
+const size_t TRUTH_TABLE_MAX_VARS = 6;
+
+///\returns The truth table of the variable var_idx
+inline TruthTable tt_var(size_t var_idx) {
+    static const TruthTable VAR_TABLES[TRUTH_TABLE_MAX_VARS] = {
+        0xAAAAAAAAAAAAAAAAull,
+        0xCCCCCCCCCCCCCCCCull,
+        0xF0F0F0F0F0F0F0F0ull,
+        0xFF00FF00FF00FF00ull,
+        0xFFFF0000FFFF0000ull,
+        0xFFFFFFFF00000000ull
+    };
+    return VAR_TABLES[var_idx];
+}
+
+inline bool tt_is_one(TruthTable f) { return f == ~TruthTable(0); }
+inline bool tt_is_zero(TruthTable f) { return f == 0; }
+
+///\returns The cofactor of f with respect to variable var_idx having value
+inline TruthTable tt_cofactor(TruthTable f, size_t var_idx, bool value) {
+    TruthTable var = tt_var(var_idx);
+    size_t shift = size_t(1) << var_idx;
+    if(value) {
+        f &= var;
+        return f | (f >> shift);
+    } else {
+        f &= ~var;
+        return f | (f << shift);
+    }
+}
+
+///\returns The restriction of f after variable var_idx takes on the final value of input_trans
+inline TruthTable tt_restrict(TruthTable f, size_t var_idx, TransitionType input_trans) {
+    //FALL/LOW transitions result in logically false values
+    bool value = !(input_trans == TransitionType::LOW || input_trans == TransitionType::FALL);
+    return tt_cofactor(f, var_idx, value);
+}
+
+///\returns The function value for the minterm (bit i of minterm is the value of variable i)
+inline bool tt_eval(TruthTable f, size_t minterm) { return (f >> minterm) & 1; }
+
+///Converts a BDD into a truth table
+///\param f The function to convert
+///\param tt Set to the truth table of f on success
+///\returns false if f depends on variables outside the truth table (tt is unchanged)
+bool bdd_to_truth_table(const BDD& f, TruthTable& tt);
@@ -0,0 +1,216 @@
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+#include "cuddInt.h"
+#include "mtr.h"
+
+#include "var_order.hpp"
+
+bool is_bdd_input_node(const TimingGraph& tg, NodeId node_id) {
+    auto node_type = tg.node_type(node_id);
+    return node_type == TN_Type::INPAD_SOURCE || node_type == TN_Type::FF_SOURCE;
+}
+
+std::vector<NodeId> order_input_nodes(const TimingGraph& tg, InputVarOrder order) {
+    std::vector<NodeId> input_order;
+
+    if(order == InputVarOrder::DFS) {
+        auto deeper = [&](NodeId lhs, NodeId rhs) {
+            return tg.node_level(lhs) > tg.node_level(rhs);
+        };
+
+        //Walk the deepest cones first, since they have the most complex functions
+        std::vector<NodeId> roots = tg.primary_outputs();
+        std::stable_sort(roots.begin(), roots.end(), deeper);
+
+        std::vector<bool> visited(tg.num_nodes(), false);
+        std::vector<NodeId> stack;
+        std::vector<NodeId> fanins;
+        for(NodeId root_id : roots) {
+            stack.push_back(root_id);
+            while(!stack.empty()) {
+                NodeId node_id = stack.back();
+                stack.pop_back();
+
+                if(visited[node_id]) continue;
+                visited[node_id] = true;
+
+                if(is_bdd_input_node(tg, node_id)) {
+                    input_order.push_back(node_id);
+                }
+
+                //Visit the deepest fanins first (ties in edge order), so they are pushed in reverse
+                fanins.clear();
+                for(int edge_idx = 0; edge_idx < tg.num_node_in_edges(node_id); ++edge_idx) {
+                    fanins.push_back(tg.edge_src_node(tg.node_in_edge(node_id, edge_idx)));
+                }
+                std::stable_sort(fanins.begin(), fanins.end(), deeper);
+                for(auto iter = fanins.rbegin(); iter != fanins.rend(); ++iter) {
+                    if(!visited[*iter]) {
+                        stack.push_back(*iter);
+                    }
+                }
+            }
+        }
+
+        //Any inputs which do not reach an output go last
+        for(NodeId node_id = 0; node_id < tg.num_nodes(); ++node_id) {
+            if(!visited[node_id] && is_bdd_input_node(tg, node_id)) {
+                input_order.push_back(node_id);
+            }
+        }
+    } else {
+        assert(order == InputVarOrder::NETLIST);
+        for(NodeId node_id = 0; node_id < tg.num_nodes(); ++node_id) {
+            if(is_bdd_input_node(tg, node_id)) {
+                input_order.push_back(node_id);
+            }
+        }
+    }
+
+    return input_order;
+}
+
+std::vector<std::vector<BDD>> order_input_var_groups(const std::vector<NodeId>& default_input_order,
+                                                     const std::map<NodeId,std::vector<BDD>>& input_vars,
+                                                     const std::vector<std::string>& var_roles,
+                                                     const std::vector<InputVar>& saved_order) {
+    std::map<std::string,size_t> role_indicies;
+    for(size_t i = 0; i < var_roles.size(); ++i) {
+        role_indicies[var_roles[i]] = i;
+    }
+
+    //The inputs in the saved order, and the saved order of each one's variables (by role index)
+    std::vector<NodeId> input_order;
+    std::map<NodeId,std::vector<size_t>> input_role_orders;
+    for(const InputVar& saved_var : saved_order) {
+        auto var_iter = input_vars.find(saved_var.first);
+        auto role_iter = role_indicies.find(saved_var.second);
+        if(var_iter == input_vars.end() || role_iter == role_indicies.end()) continue;
+        if(role_iter->second >= var_iter->second.size()) continue;
+
+        auto result = input_role_orders.insert(std::make_pair(saved_var.first, std::vector<size_t>()));
+        if(result.second) {
+            input_order.push_back(saved_var.first);
+        }
+
+        auto& role_order = result.first->second;
+        if(std::find(role_order.begin(), role_order.end(), role_iter->second) == role_order.end()) {
+            role_order.push_back(role_iter->second);
+        }
+    }
+
+    //Followed by any new inputs
+    for(NodeId node_id : default_input_order) {
+        if(!input_role_orders.count(node_id)) {
+            input_role_orders[node_id];
+            input_order.push_back(node_id);
+        }
+    }
+
+    std::vector<std::vector<BDD>> var_groups;
+    for(NodeId node_id : input_order) {
+        const auto& vars = input_vars.at(node_id);
+        auto& role_order = input_role_orders[node_id];
+
+        //Followed by any new roles
+        for(size_t i = 0; i < vars.size(); ++i) {
+            if(std::find(role_order.begin(), role_order.end(), i) == role_order.end()) {
+                role_order.push_back(i);
+            }
+        }
+
+        var_groups.emplace_back();
+        for(size_t i : role_order) {
+            var_groups.back().push_back(vars[i]);
+        }
+    }
+
+    return var_groups;
+}
+
+void apply_input_var_order(Cudd& cudd, const std::vector<std::vector<BDD>>& var_groups) {
+    DdManager* dd = cudd.getManager();
+    int nvars = cudd.ReadSize();
+
+    //The new order (variable index at each level): the non-input variables keep their
+    //current relative order at the top, followed by each input's variables
+    std::vector<bool> is_input_var(nvars, false);
+    for(const auto& vars : var_groups) {
+        for(const BDD& var : vars) {
+            is_input_var[var.NodeReadIndex()] = true;
+        }
+    }
+
+    std::vector<int> permutation;
+    for(int level = 0; level < nvars; ++level) {
+        int var_idx = Cudd_ReadInvPerm(dd, level);
+        if(!is_input_var[var_idx]) {
+            permutation.push_back(var_idx);
+        }
+    }
+    for(const auto& vars : var_groups) {
+        for(const BDD& var : vars) {
+            permutation.push_back(var.NodeReadIndex());
+        }
+    }
+    assert(permutation.size() == size_t(nvars));
+
+    if(!Cudd_ShuffleHeap(dd, permutation.data())) {
+        throw std::runtime_error("Failed to apply static BDD variable order");
+    }
+
+    //Group each input's variables so reordering keeps them together.
+    //Groups are specified by the index of their top variable (now placed first).
+    for(const auto& vars : var_groups) {
+        if(vars.size() < 2) continue;
+
+        if(!Cudd_MakeTreeNode(dd, vars[0].NodeReadIndex(), vars.size(), MTR_DEFAULT)) {
+            throw std::runtime_error("Failed to group BDD variables");
+        }
+    }
+}
+
+std::vector<int> manager_var_order(Cudd& cudd) {
+    std::vector<int> var_order;
+    for(int level = 0; level < cudd.ReadSize(); ++level) {
+        var_order.push_back(cudd.ReadInvPerm(level));
+    }
+    return var_order;
+}
+
+bool restore_manager_var_order(Cudd& cudd, const std::vector<int>& var_order) {
+    if(var_order.size() != size_t(cudd.ReadSize())) {
+        return false;
+    }
+
+    std::vector<int> permutation = var_order;
+    if(!Cudd_ShuffleHeap(cudd.getManager(), permutation.data())) {
+        throw std::runtime_error("Failed to restore BDD variable order");
+    }
+    return true;
+}
+
+void write_var_order(std::ostream& os, const std::vector<NamedInputVar>& var_order) {
+    for(const NamedInputVar& var : var_order) {
+        os << var.first << " " << var.second << "\n";
+    }
+}
+
+std::vector<NamedInputVar> read_var_order(std::istream& is) {
+    std::vector<NamedInputVar> var_order;
+
+    std::string line;
+    while(std::getline(is, line)) {
+        std::istringstream line_ss(line);
+        NamedInputVar var;
+        if(line_ss >> var.first >> var.second) {
+            var_order.push_back(var);
+        }
+    }
+
+    return var_order;
+}
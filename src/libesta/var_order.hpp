@@ -0,0 +1,73 @@
+#pragma once
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bdd.hpp"
+#include "TimingGraph.hpp"
+
+//How the BDD variables of the primary inputs are (statically) ordered
+enum class InputVarOrder {
+    NETLIST, //In node id (i.e. netlist) order
+    DFS      //By a depth-first traversal of the fanin cones of the primary outputs
+};
+
+//A primary input's BDD variable, identified by the input and the variable's role (e.g. "curr" or "next")
+typedef std::pair<NodeId,std::string> InputVar;
+
+//An input variable identified by the input's name, so it remains valid across runs
+typedef std::pair<std::string,std::string> NamedInputVar;
+
+///\returns true if the node is a primary input which is allocated BDD variables
+bool is_bdd_input_node(const TimingGraph& tg, NodeId node_id);
+
+///Orders the primary inputs of the timing graph for BDD variable allocation.
+///
+///The DFS order walks the fanin cones of the primary outputs (deepest outputs first,
+///and deepest fanins first within each cone), placing each input when it is first reached.
+///Inputs which feed the same gates therefore end up close together in the order, and the
+///inputs of each additional output's cone are interleaved with those already placed.
+///
+///\param tg The (levelized) timing graph
+///\param order The ordering to use
+///\returns The primary inputs in the order their variables should be placed
+std::vector<NodeId> order_input_nodes(const TimingGraph& tg, InputVarOrder order);
+
+///Groups the variables of each primary input, following a previously saved order where possible.
+///
+///The inputs (and each input's variables) in the saved order are placed first, in the saved order.
+///Any other inputs follow in the default order, and any other variables of an input follow those
+///in the saved order (in their role order). Saved variables of unknown inputs or roles are ignored.
+///
+///\param default_input_order The primary inputs in their default order (see order_input_nodes())
+///\param input_vars The variables of each primary input
+///\param var_roles The role of each of an input's variables
+///\param saved_order The saved order of the input variables, from top to bottom (may be empty)
+///\returns The variables of each input, in the order they should be placed
+std::vector<std::vector<BDD>> order_input_var_groups(const std::vector<NodeId>& default_input_order,
+                                                     const std::map<NodeId,std::vector<BDD>>& input_vars,
+                                                     const std::vector<std::string>& var_roles,
+                                                     const std::vector<InputVar>& saved_order);
+
+///Places the variables of the primary inputs at the bottom of the manager's order (in the
+///specified order) and groups each input's variables, so that dynamic reordering keeps them
+///adjacent and moves them as a unit.
+///
+///\param cudd The manager owning the variables
+///\param var_groups The variables of each primary input, in the order they should be placed
+void apply_input_var_order(Cudd& cudd, const std::vector<std::vector<BDD>>& var_groups);
+
+///\returns The manager's current variable order (the index of the variable at each level, from top to bottom)
+std::vector<int> manager_var_order(Cudd& cudd);
+
+///Restores a variable order returned by manager_var_order()
+///\returns false (leaving the order unchanged) if the manager has a different number of variables
+bool restore_manager_var_order(Cudd& cudd, const std::vector<int>& var_order);
+
+///Writes a variable order, one "<input name> <role>" per line from top to bottom
+void write_var_order(std::ostream& os, const std::vector<NamedInputVar>& var_order);
+
+///\returns The variable order read from a stream written by write_var_order()
+std::vector<NamedInputVar> read_var_order(std::istream& is);
@@ -0,0 +1,159 @@
+/*
+ * Microbenchmark for StaSlackTagReducer::merge_tags()
+ *
+ * Compares the reducer against the previous linear search (find the first
+ * already merged tag in the same bin) on randomly generated tag sets.
+ *
+ * Usage: tag_reducer_bench [num_tags ...]
+ */
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "TagReducer.hpp"
+
+using std::cout;
+using std::endl;
+
+//Coarse/fine bin sizes and slack threshold (ps)
+const double COARSE_BIN_SIZE = 1.;
+const double FINE_BIN_SIZE = 0.1;
+const double SLACK_THRESHOLD = 100.;
+const double REQ_TIME = 500.;
+
+const size_t NUM_REPEATS = 5;
+
+Tags linear_merge_tags(const Tags& orig_tags, const double coarse_delay_bin_size, const double fine_delay_bin_size, const double arr_threshold);
+Tags make_tags(size_t num_tags, std::mt19937& rng);
+
+/*
+ * Minimal analyzer providing the STA required time the reducer needs
+ */
+class BenchStaTag {
+    public:
+        Time req_time() const { return Time(REQ_TIME); }
+};
+
+class BenchStaTags {
+    public:
+        size_t num_tags() const { return 1; }
+        const BenchStaTag* begin() const { return &tag_; }
+    private:
+        BenchStaTag tag_;
+};
+
+class BenchStaAnalyzer {
+    public:
+        BenchStaTags setup_data_tags(NodeId /*node_id*/) const { return BenchStaTags(); }
+};
+
+//The previous (quadratic) implementation of StaSlackTagReducer::merge_tags()
+Tags linear_merge_tags(const Tags& orig_tags, const double coarse_delay_bin_size, const double fine_delay_bin_size, const double arr_threshold) {
+    Tags merged_tags;
+
+    for(const auto& tag : orig_tags) {
+        auto bin_tag_pred = [&](Tags::Tag::cptr search_tag) {
+            if(tag->trans_type() != search_tag->trans_type()) return false;
+
+            if(tag->arr_time().value() > arr_threshold && search_tag->arr_time().value() <= arr_threshold) {
+                return false;
+            }
+
+            auto bin_size = coarse_delay_bin_size;
+            if(search_tag->arr_time().value() > arr_threshold) {
+                bin_size = fine_delay_bin_size;
+            }
+
+            double tag_bin = tag->arr_time().value();
+            double search_tag_bin = search_tag->arr_time().value();
+            if(bin_size != 0.) {
+                tag_bin = std::floor(tag_bin / bin_size);
+                search_tag_bin = std::floor(search_tag_bin / bin_size);
+            }
+            return tag_bin == search_tag_bin;
+        };
+
+        auto iter = std::find_if(merged_tags.begin(), merged_tags.end(), bin_tag_pred);
+        if(iter != merged_tags.end()) {
+            merged_tags.max_arr(iter, tag);
+        } else {
+            merged_tags.add_tag(tag);
+        }
+    }
+    return merged_tags;
+}
+
+Tags make_tags(size_t num_tags, std::mt19937& rng) {
+    const TransitionType transitions[] = {TransitionType::RISE, TransitionType::FALL, TransitionType::HIGH, TransitionType::LOW};
+
+    //Distinct arrival times (as produced at a node before binning)
+    std::uniform_real_distribution<double> arr_dist(0., REQ_TIME);
+    Tags tags;
+    for(size_t i = 0; i < num_tags; ++i) {
+        tags.add_tag(ExtTimingTag::make_ptr(Time(arr_dist(rng)), Time(NAN), 0, i, transitions[i % 4]));
+    }
+    return tags;
+}
+
+//Returns the average run-time (in seconds) of merge_func() applied to copies of tags
+//(merging modifies the tags, so each run gets its own copy)
+template<class MergeFunc>
+double time_merge(const Tags& tags, MergeFunc merge_func) {
+    double total_time = 0.;
+    for(size_t i = 0; i < NUM_REPEATS; ++i) {
+        Tags tags_copy;
+        for(auto tag : tags) {
+            tags_copy.add_tag(ExtTimingTag::make_ptr(*tag));
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        merge_func(tags_copy);
+        auto end = std::chrono::steady_clock::now();
+
+        total_time += std::chrono::duration<double>(end - start).count();
+    }
+    return total_time / NUM_REPEATS;
+}
+
+int main(int argc, char** argv) {
+    std::vector<size_t> tag_counts = {100, 1000, 4000, 16000, 64000};
+    if(argc > 1) {
+        tag_counts.clear();
+        for(int i = 1; i < argc; ++i) {
+            tag_counts.push_back(std::strtoul(argv[i], nullptr, 10));
+        }
+    }
+
+    StaSlackTagReducer<BenchStaAnalyzer> reducer(std::make_shared<BenchStaAnalyzer>(), SLACK_THRESHOLD, COARSE_BIN_SIZE, FINE_BIN_SIZE);
+
+    std::mt19937 rng(1);
+    for(size_t num_tags : tag_counts) {
+        Tags tags = make_tags(num_tags, rng);
+
+        size_t num_merged = 0;
+        double reducer_time = time_merge(tags, [&](const Tags& tags_copy) {
+            num_merged = reducer.merge_tags(0, tags_copy).num_tags();
+        });
+
+        size_t num_linear_merged = 0;
+        double linear_time = time_merge(tags, [&](const Tags& tags_copy) {
+            num_linear_merged = linear_merge_tags(tags_copy, COARSE_BIN_SIZE, FINE_BIN_SIZE, REQ_TIME - SLACK_THRESHOLD).num_tags();
+        });
+
+        if(num_merged != num_linear_merged) {
+            cout << "Error: reducer produced " << num_merged << " tags, expected " << num_linear_merged << endl;
+            return 1;
+        }
+
+        cout << "Tags: " << num_tags << " -> " << num_merged;
+        cout << " Sort-and-sweep: " << reducer_time * 1e3 << " ms";
+        cout << " Linear search: " << linear_time * 1e3 << " ms";
+        cout << " Speed-up: " << linear_time / reducer_time << "x" << endl;
+
+        g_scenario_store.clear();
+    }
+
+    return 0;
+}
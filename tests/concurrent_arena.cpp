@@ -0,0 +1,47 @@
+#include <sstream>
+#include <stdexcept>
+
+#include "gtest/gtest.h"
+
+#include "ConcurrentArena.hpp"
+
+//Small chunks so a test can cross several chunk boundaries
+typedef ConcurrentArena<uint32_t,12> SmallArena;
+
+TEST(ConcurrentArena, LargeAllocationsSkipWholeChunks) {
+    SmallArena arena;
+
+    //Each allocation is over half a chunk, so the second straddles the first chunk boundary, and
+    //its retry straddles the second, leaving the second chunk covered only by skipped ranges
+    const size_t num_elements = 3 * SmallArena::CHUNK_SIZE / 4;
+    uint32_t first = arena.allocate(num_elements);
+    uint32_t second = arena.allocate(num_elements);
+    EXPECT_EQ(first, 0u);
+    EXPECT_EQ(second >> 12, 2u);
+
+    for(size_t i = 0; i < num_elements; ++i) {
+        arena[first + i] = i;
+        arena[second + i] = 2 * i;
+    }
+
+    //Writing walks every chunk below size(), including the skipped one
+    std::stringstream ss;
+    arena.write(ss);
+
+    SmallArena restored;
+    restored.read(ss);
+    ASSERT_EQ(restored.size(), arena.size());
+    for(size_t i = 0; i < num_elements; ++i) {
+        EXPECT_EQ(restored[first + i], i);
+        EXPECT_EQ(restored[second + i], 2 * i);
+    }
+}
+
+TEST(ConcurrentArena, RejectsAllocationsLargerThanAChunk) {
+    SmallArena arena;
+
+    EXPECT_THROW(arena.allocate(SmallArena::CHUNK_SIZE + 1), std::length_error);
+
+    //A whole chunk is fine
+    EXPECT_EQ(arena.allocate(SmallArena::CHUNK_SIZE), 0u);
+}
@@ -0,0 +1,73 @@
+#include <limits>
+
+#include "gtest/gtest.h"
+
+#include "ExtTimingTags.hpp"
+
+TEST(ExtTimingTags, FindMatchingTagAgreesWithTagMatches) {
+    std::vector<TransitionType> transitions = {TransitionType::RISE, TransitionType::FALL, TransitionType::HIGH, TransitionType::LOW, TransitionType::MAX};
+
+    //Scanned (spanning several match blocks) and indexed sets
+    for(size_t num_tags : {3*TAG_MATCH_BLOCK_SIZE + 5, 4*TAG_INDEX_MIN_TAGS}) {
+        ExtTimingTags tags;
+        for(size_t i = 0; i < num_tags; ++i) {
+            tags.add_tag(ExtTimingTag::make_ptr(Time(i / 4), Time(NAN), 0, i, transitions[i % 5]));
+        }
+
+        for(float arr : {0., 3., 10., 12., 30., 1000.}) {
+            for(TransitionType trans : transitions) {
+                auto expected = std::find_if(tags.begin(), tags.end(), [&](ExtTimingTag::cptr tag) {
+                    return tag->matches(0, trans, Time(arr));
+                });
+                EXPECT_EQ(tags.find_matching_tag(0, trans, Time(arr)), expected);
+            }
+        }
+        EXPECT_EQ(tags.find_matching_tag(1, TransitionType::RISE, Time(0.)), tags.end());
+        EXPECT_EQ(tags.find_matching_tag(0, TransitionType::RISE, Time(NAN)), tags.end());
+    }
+}
+
+TEST(ExtTimingTags, MaxArrAndSortUpdateMatching) {
+    ExtTimingTags tags;
+    tags.add_tag(ExtTimingTag::make_ptr(Time(1.), Time(NAN), 0, 0, TransitionType::MAX));
+    tags.add_tag(ExtTimingTag::make_ptr(Time(2.), Time(NAN), 0, 1, TransitionType::MAX));
+
+    //Large enough to be indexed
+    for(size_t i = 0; i < TAG_INDEX_MIN_TAGS; ++i) {
+        tags.add_tag(ExtTimingTag::make_ptr(Time(100. + i), Time(NAN), 0, i, TransitionType::MAX));
+    }
+
+    //MAX tags match any transition
+    auto iter = tags.find_matching_tag(0, TransitionType::FALL, Time(1.));
+    ASSERT_EQ(iter, tags.begin());
+
+    tags.max_arr(iter, Time(5.), 2, INVALID_SCENARIO_ID);
+    EXPECT_EQ(tags.find_matching_tag(0, TransitionType::RISE, Time(1.)), tags.end());
+    EXPECT_EQ(tags.find_matching_tag(0, TransitionType::RISE, Time(5.)), tags.begin());
+
+    tags.sort([](ExtTimingTag::cptr lhs, ExtTimingTag::cptr rhs) {
+        return lhs->arr_time().value() < rhs->arr_time().value();
+    });
+    EXPECT_EQ((*tags.begin())->arr_time().value(), 2.);
+    EXPECT_EQ(tags.find_matching_tag(0, TransitionType::RISE, Time(5.)), tags.begin() + 1);
+}
+
+TEST(ExtTimingTags, IndexedMatchingDistinguishesDomains) {
+    std::vector<DomainId> domains = {INVALID_CLOCK_DOMAIN, 0, 1, std::numeric_limits<DomainId>::max(), std::numeric_limits<DomainId>::min()};
+
+    //Tags with the same transition and arrival time in each domain, in scanned and indexed sets
+    for(size_t num_tags : {2*domains.size(), 4*TAG_INDEX_MIN_TAGS}) {
+        ExtTimingTags tags;
+        for(size_t i = 0; i < num_tags; ++i) {
+            tags.add_tag(ExtTimingTag::make_ptr(Time(i / domains.size()), Time(NAN), domains[i % domains.size()], i, TransitionType::RISE));
+        }
+
+        for(DomainId domain : domains) {
+            auto iter = tags.find_matching_tag(domain, TransitionType::RISE, Time(1.));
+            ASSERT_NE(iter, tags.end());
+            EXPECT_EQ((*iter)->clock_domain(), domain);
+            EXPECT_EQ((*iter)->arr_time().value(), 1.);
+        }
+        EXPECT_EQ(tags.find_matching_tag(2, TransitionType::RISE, Time(0.)), tags.end());
+    }
+}
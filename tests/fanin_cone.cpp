@@ -0,0 +1,49 @@
+#include "gtest/gtest.h"
+
+#include "fanin_cone.hpp"
+
+TEST(FaninCone, ExtractsOnlyFaninOfRoots) {
+    //Two independent input -> output paths, plus a shared input driving a 2-input node on the first
+    //
+    //  in0 -> a -> out0
+    //  in1 -^
+    //  in2 -> b -> out1
+    TimingGraph tg;
+    NodeId in0 = tg.add_node(TN_Type::INPAD_SOURCE, 0, false);
+    NodeId in1 = tg.add_node(TN_Type::INPAD_SOURCE, 0, false);
+    NodeId in2 = tg.add_node(TN_Type::INPAD_SOURCE, 0, false);
+    NodeId a = tg.add_node(TN_Type::PRIMITIVE_OPIN, 0, false);
+    NodeId b = tg.add_node(TN_Type::PRIMITIVE_OPIN, 0, false);
+    NodeId out0 = tg.add_node(TN_Type::OUTPAD_SINK, 0, false);
+    NodeId out1 = tg.add_node(TN_Type::OUTPAD_SINK, 0, false);
+
+    tg.set_node_truth_table(a, 0x8); //in0 & in1
+    tg.add_edge(in2, b);
+    EdgeId in0_a = tg.add_edge(in0, a);
+    EdgeId in1_a = tg.add_edge(in1, a);
+    tg.add_edge(b, out1);
+    EdgeId a_out0 = tg.add_edge(a, out0);
+    tg.levelize();
+
+    TimingGraph cone_tg;
+    std::vector<NodeId> cone_to_orig_nodes;
+    std::vector<EdgeId> cone_to_orig_edges;
+    extract_fanin_cone(tg, {out0}, cone_tg, cone_to_orig_nodes, cone_to_orig_edges);
+
+    EXPECT_EQ(cone_to_orig_nodes, std::vector<NodeId>({in0, in1, a, out0}));
+    EXPECT_EQ(cone_to_orig_edges, std::vector<EdgeId>({in0_a, in1_a, a_out0}));
+    ASSERT_EQ(cone_tg.num_nodes(), 4);
+    ASSERT_EQ(cone_tg.num_edges(), 3);
+
+    EXPECT_EQ(cone_tg.logical_inputs().size(), 2u);
+    EXPECT_EQ(cone_tg.primary_outputs(), std::vector<NodeId>({3}));
+
+    //The node's inputs keep their original order, so its truth table remains valid
+    NodeId cone_a = 2;
+    EXPECT_EQ(cone_tg.node_type(cone_a), TN_Type::PRIMITIVE_OPIN);
+    ASSERT_TRUE(cone_tg.node_has_truth_table(cone_a));
+    EXPECT_EQ(cone_tg.node_truth_table(cone_a), 0x8u);
+    ASSERT_EQ(cone_tg.num_node_in_edges(cone_a), 2);
+    EXPECT_EQ(cone_tg.edge_src_node(cone_tg.node_in_edge(cone_a, 0)), 0);
+    EXPECT_EQ(cone_tg.edge_src_node(cone_tg.node_in_edge(cone_a, 1)), 1);
+}
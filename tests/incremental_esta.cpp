@@ -0,0 +1,109 @@
+#include <tuple>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "TimingGraph.hpp"
+#include "TimingConstraints.hpp"
+#include "PreCalcTransDelayCalc.hpp"
+#include "IncrementalEstaTimingAnalyzer.hpp"
+
+namespace {
+
+typedef ExtSetupAnalysisMode<BaseAnalysisMode,ExtTimingTags> EstaAnalysisType;
+typedef IncrementalEstaTimingAnalyzer<EstaAnalysisType,PreCalcTransDelayCalculator> EstaAnalyzer;
+
+//The timing of a tag and the number of scenarios generating it
+typedef std::tuple<TransitionType,float,size_t> TagSummary;
+
+//The tags of every node (the tags themselves only remain valid until the next analysis starts)
+std::vector<std::vector<TagSummary>> summarize_tags(const TimingGraph& tg, const EstaAnalyzer& analyzer) {
+    std::vector<std::vector<TagSummary>> node_tags(tg.num_nodes());
+    for(NodeId node_id = 0; node_id < tg.num_nodes(); ++node_id) {
+        for(auto tag : analyzer.setup_data_tags(node_id)) {
+            node_tags[node_id].emplace_back(tag->trans_type(), tag->arr_time().value(), tag->num_scenarios());
+        }
+    }
+    return node_tags;
+}
+
+}
+
+TEST(IncrementalEsta, UpdateMatchesFullAnalysis) {
+    //Two inputs feeding an AND and an OR gate
+    //
+    //  in0 -> opin0 --+--> and_gate -> and_out
+    //                 '--> or_gate  -> or_out
+    //  in1 -> opin1 --+--> and_gate
+    //                 '--> or_gate
+    TimingGraph tg;
+    NodeId in0 = tg.add_node(TN_Type::INPAD_SOURCE, 0, false);
+    NodeId in1 = tg.add_node(TN_Type::INPAD_SOURCE, 0, false);
+    NodeId opin0 = tg.add_node(TN_Type::INPAD_OPIN, INVALID_CLOCK_DOMAIN, false);
+    NodeId opin1 = tg.add_node(TN_Type::INPAD_OPIN, INVALID_CLOCK_DOMAIN, false);
+    NodeId and_gate = tg.add_node(TN_Type::PRIMITIVE_OPIN, INVALID_CLOCK_DOMAIN, false);
+    NodeId or_gate = tg.add_node(TN_Type::PRIMITIVE_OPIN, INVALID_CLOCK_DOMAIN, false);
+    NodeId and_out = tg.add_node(TN_Type::OUTPAD_SINK, 0, false);
+    NodeId or_out = tg.add_node(TN_Type::OUTPAD_SINK, 0, false);
+
+    tg.add_edge(in0, opin0);
+    tg.add_edge(in1, opin1);
+    EdgeId and_edge = tg.add_edge(opin0, and_gate);
+    tg.add_edge(opin1, and_gate);
+    tg.add_edge(opin0, or_gate);
+    tg.add_edge(opin1, or_gate);
+    tg.add_edge(and_gate, and_out);
+    tg.add_edge(or_gate, or_out);
+
+    //Node functions are in terms of the node's input edges
+    for(NodeId node_id : {in0, in1, opin0, opin1, and_out, or_out}) {
+        tg.set_node_func(node_id, g_cudd.bddVar(0));
+    }
+    tg.set_node_func(and_gate, g_cudd.bddVar(0) & g_cudd.bddVar(1));
+    tg.set_node_func(or_gate, g_cudd.bddVar(0) | g_cudd.bddVar(1));
+    tg.levelize();
+
+    //Distinct delays, so the arrival times depend on the path taken
+    PreCalcTransDelayCalculator::EdgeDelayModel edge_delays(tg.num_edges());
+    for(EdgeId edge_id = 0; edge_id < tg.num_edges(); ++edge_id) {
+        for(auto trans : {TransitionType::RISE, TransitionType::FALL, TransitionType::HIGH, TransitionType::LOW}) {
+            edge_delays[edge_id][trans] = Time(1. + edge_id);
+        }
+    }
+    PreCalcTransDelayCalculator delay_calc(edge_delays);
+
+    TimingConstraints tc;
+    NoOpTagReducer tag_reducer;
+
+    //Initial analysis, then slow down one input of the AND gate and update
+    EstaAnalyzer incr_analyzer(tg, tc, delay_calc, tag_reducer);
+    incr_analyzer.calculate_timing();
+
+    std::vector<ExtTimingTag::cptr> or_tags(incr_analyzer.setup_data_tags(or_gate).begin(), incr_analyzer.setup_data_tags(or_gate).end());
+
+    for(auto trans : {TransitionType::RISE, TransitionType::FALL}) {
+        delay_calc.set_max_edge_delay(and_edge, trans, Time(10.));
+    }
+    incr_analyzer.update_timing({and_edge});
+
+    EXPECT_FALSE(incr_analyzer.replaced_tags().empty());
+
+    //Nodes outside the fanout of the modified edge keep their tags
+    std::vector<ExtTimingTag::cptr> updated_or_tags(incr_analyzer.setup_data_tags(or_gate).begin(), incr_analyzer.setup_data_tags(or_gate).end());
+    EXPECT_EQ(updated_or_tags, or_tags);
+
+    auto incr_tags = summarize_tags(tg, incr_analyzer);
+
+    //A full re-analysis with the modified delays (this releases the previous analysis' tags)
+    EstaAnalyzer full_analyzer(tg, tc, delay_calc, tag_reducer);
+    full_analyzer.calculate_timing();
+
+    auto full_tags = summarize_tags(tg, full_analyzer);
+
+    EXPECT_FALSE(full_tags[and_out].empty());
+    for(NodeId node_id = 0; node_id < tg.num_nodes(); ++node_id) {
+        EXPECT_EQ(incr_tags[node_id], full_tags[node_id]) << "Node " << node_id;
+    }
+
+    g_scenario_store.clear();
+}
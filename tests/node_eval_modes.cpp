@@ -0,0 +1,126 @@
+#include <map>
+#include <set>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "TimingGraph.hpp"
+#include "TimingConstraints.hpp"
+#include "PreCalcTransDelayCalc.hpp"
+#include "SerialTimingAnalyzer.hpp"
+#include "ExtSetupAnalysisMode.hpp"
+
+namespace {
+
+typedef ExtSetupAnalysisMode<BaseAnalysisMode,ExtTimingTags> EstaAnalysisType;
+typedef SerialTimingAnalyzer<EstaAnalysisType,PreCalcTransDelayCalculator> EstaAnalyzer;
+
+//The output transitions produced at a node for each combination of input transitions
+typedef std::map<std::vector<TransitionType>,std::set<TransitionType>> TransitionMap;
+
+TransitionMap node_transitions(const EstaAnalyzer& analyzer, NodeId node_id) {
+    TransitionMap transitions;
+    for(auto tag : analyzer.setup_data_tags(node_id)) {
+        g_scenario_store.for_each_scenario(tag->scenarios(), [&](const ScenarioStore::Scenario& scenario) {
+            //Expand the product of each input's alternative tags
+            std::vector<size_t> alternatives(scenario.num_inputs(), 0);
+            while(true) {
+                std::vector<TransitionType> input_transitions;
+                for(size_t i = 0; i < scenario.num_inputs(); ++i) {
+                    input_transitions.push_back(scenario.alternative_tag(i, alternatives[i])->trans_type());
+                }
+                transitions[input_transitions].insert(tag->trans_type());
+
+                size_t i = 0;
+                for(; i < scenario.num_inputs(); ++i) {
+                    if(++alternatives[i] < scenario.num_alternatives(i)) break;
+                    alternatives[i] = 0;
+                }
+                if(i == scenario.num_inputs()) break;
+            }
+        });
+    }
+    return transitions;
+}
+
+bool is_dynamic(TransitionType trans) {
+    return trans == TransitionType::RISE || trans == TransitionType::FALL;
+}
+
+}
+
+TEST(NodeEvalModes, ConvolutionMatchesPermutationForDynamicInputs) {
+    //Two inputs feeding an AND and an XOR gate
+    //
+    //  in0 -> opin0 --+--> and_gate
+    //                 '--> xor_gate
+    //  in1 -> opin1 --+--> and_gate
+    //                 '--> xor_gate
+    TimingGraph tg;
+    NodeId in0 = tg.add_node(TN_Type::INPAD_SOURCE, 0, false);
+    NodeId in1 = tg.add_node(TN_Type::INPAD_SOURCE, 0, false);
+    NodeId opin0 = tg.add_node(TN_Type::INPAD_OPIN, INVALID_CLOCK_DOMAIN, false);
+    NodeId opin1 = tg.add_node(TN_Type::INPAD_OPIN, INVALID_CLOCK_DOMAIN, false);
+    NodeId and_gate = tg.add_node(TN_Type::PRIMITIVE_OPIN, INVALID_CLOCK_DOMAIN, false);
+    NodeId xor_gate = tg.add_node(TN_Type::PRIMITIVE_OPIN, INVALID_CLOCK_DOMAIN, false);
+
+    tg.add_edge(in0, opin0);
+    tg.add_edge(in1, opin1);
+    tg.add_edge(opin0, and_gate);
+    tg.add_edge(opin1, and_gate);
+    tg.add_edge(opin0, xor_gate);
+    tg.add_edge(opin1, xor_gate);
+
+    //Node functions are in terms of the node's input edges
+    for(NodeId node_id : {in0, in1, opin0, opin1}) {
+        tg.set_node_func(node_id, g_cudd.bddVar(0));
+    }
+    tg.set_node_func(and_gate, g_cudd.bddVar(0) & g_cudd.bddVar(1));
+    tg.set_node_func(xor_gate, g_cudd.bddVar(0) ^ g_cudd.bddVar(1));
+    tg.levelize();
+
+    //Distinct delays, so the inputs arrive at different times
+    PreCalcTransDelayCalculator::EdgeDelayModel edge_delays(tg.num_edges());
+    for(EdgeId edge_id = 0; edge_id < tg.num_edges(); ++edge_id) {
+        for(auto trans : {TransitionType::RISE, TransitionType::FALL, TransitionType::HIGH, TransitionType::LOW}) {
+            edge_delays[edge_id][trans] = Time(1. + edge_id);
+        }
+    }
+    PreCalcTransDelayCalculator delay_calc(edge_delays);
+
+    TimingConstraints tc;
+    NoOpTagReducer tag_reducer;
+
+    //Each analysis releases the previous one's tags, so summarize them first
+    std::map<NodeEvalMode,std::vector<TransitionMap>> mode_transitions;
+    for(NodeEvalMode mode : {NodeEvalMode::PERMUTATION, NodeEvalMode::CONVOLUTION}) {
+        EstaAnalyzer analyzer(tg, tc, delay_calc, tag_reducer);
+        analyzer.set_node_eval_mode(mode);
+        analyzer.calculate_timing();
+
+        mode_transitions[mode] = {node_transitions(analyzer, and_gate), node_transitions(analyzer, xor_gate)};
+    }
+
+    //Glitches are dynamic transitions (to the final value) in both modes
+    using TT = TransitionType;
+    std::vector<TransitionMap>& perm = mode_transitions[NodeEvalMode::PERMUTATION];
+    std::vector<TransitionMap>& conv = mode_transitions[NodeEvalMode::CONVOLUTION];
+    std::vector<TT> rise_fall = {TT::RISE, TT::FALL};
+    std::vector<TT> rise_rise = {TT::RISE, TT::RISE};
+    std::set<TT> fall = {TT::FALL};
+    EXPECT_EQ(perm[0][rise_fall], fall);
+    EXPECT_EQ(conv[0][rise_fall], fall);
+    EXPECT_EQ(perm[1][rise_rise], fall);
+    EXPECT_EQ(conv[1][rise_rise], fall);
+
+    //With only dynamic inputs the output switches to its final value regardless of the arrival order, so the modes agree
+    for(size_t i = 0; i < perm.size(); ++i) {
+        for(const auto& kv : perm[i]) {
+            if(!is_dynamic(kv.first[0]) || !is_dynamic(kv.first[1])) continue;
+
+            EXPECT_EQ(conv[i][kv.first], kv.second) << "Gate " << i << ": " << kv.first[0] << ", " << kv.first[1];
+        }
+    }
+
+    g_scenario_store.clear();
+}
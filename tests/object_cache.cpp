@@ -0,0 +1,114 @@
+#include "gtest/gtest.h"
+
+#include <thread>
+
+#include "object_cache.hpp"
+
+TEST(ObjectCache, FindReportsHitAndValue) {
+    ObjectCache<int,int> cache(0, false);
+    EXPECT_EQ(cache.find(1), nullptr);
+
+    cache.insert(1, 10);
+    ASSERT_NE(cache.find(1), nullptr);
+    EXPECT_EQ(*cache.find(1), 10);
+
+    //Overwrite
+    cache.insert(1, 11);
+    EXPECT_EQ(*cache.find(1), 11);
+    EXPECT_EQ(cache.size(), 1u);
+
+    EXPECT_TRUE(cache.erase(1));
+    EXPECT_FALSE(cache.erase(1));
+    EXPECT_EQ(cache.find(1), nullptr);
+}
+
+TEST(ObjectCache, UniformCostEvictsLeastRecentlyUsed) {
+    ObjectCache<int,int> cache(3, false);
+    cache.insert(1, 1);
+    cache.insert(2, 2);
+    cache.insert(3, 3);
+
+    //Touch 1, so 2 is the least recently used
+    ASSERT_NE(cache.find(1), nullptr);
+
+    cache.insert(4, 4);
+    EXPECT_EQ(cache.size(), 3u);
+    EXPECT_EQ(cache.find(2), nullptr);
+    EXPECT_NE(cache.find(1), nullptr);
+    EXPECT_NE(cache.find(3), nullptr);
+    EXPECT_NE(cache.find(4), nullptr);
+}
+
+TEST(ObjectCache, EvictsCheapestEntries) {
+    ObjectCache<int,int> cache(4, false);
+    cache.insert(0, 0, 1000.); //Expensive
+    for(int i = 1; i < 100; ++i) {
+        cache.insert(i, i, 1.);
+    }
+
+    //The expensive entry out-lives many cheap ones, despite never being used again
+    EXPECT_EQ(cache.size(), 4u);
+    EXPECT_NE(cache.find(0), nullptr);
+    EXPECT_NE(cache.find(99), nullptr);
+
+    //But eventually ages out (the find() above refreshed it)
+    for(int i = 100; i < 10000; ++i) {
+        cache.insert(i, i, 1.);
+    }
+    EXPECT_EQ(cache.find(0), nullptr);
+}
+
+TEST(ObjectCache, ShrinkingCapacityEvicts) {
+    ObjectCache<int,int> cache(0, false);
+    for(int i = 0; i < 10; ++i) {
+        cache.insert(i, i);
+    }
+    cache.set_capacity(5);
+    EXPECT_EQ(cache.size(), 5u);
+
+    //Slots are re-used
+    for(int i = 10; i < 20; ++i) {
+        cache.insert(i, i);
+    }
+    EXPECT_EQ(cache.size(), 5u);
+    EXPECT_NE(cache.find(19), nullptr);
+}
+
+TEST(ShardedObjectCache, ConcurrentInsertAndFind) {
+    ShardedObjectCache<int,int> cache(8);
+
+    std::vector<std::thread> threads;
+    for(int t = 0; t < 4; ++t) {
+        threads.emplace_back([&cache, t]() {
+            for(int i = 0; i < 1000; ++i) {
+                cache.insert(t*1000 + i, i);
+            }
+        });
+    }
+    for(auto& thread : threads) {
+        thread.join();
+    }
+
+    for(int key = 0; key < 4000; ++key) {
+        int value = -1;
+        ASSERT_TRUE(cache.find(key, value));
+        EXPECT_EQ(value, key % 1000);
+    }
+}
+
+TEST(ObjectCache, CostCapacityBoundsTotalCost) {
+    ObjectCache<int,int> cache(0, false);
+    cache.set_cost_capacity(100.);
+
+    for(int i = 0; i < 50; ++i) {
+        cache.insert(i, i, 10. + i % 7);
+        EXPECT_LE(cache.total_cost(), 100.);
+    }
+    EXPECT_GT(cache.size(), 0u);
+
+    cache.evict_to_cost(20.);
+    EXPECT_LE(cache.total_cost(), 20.);
+
+    cache.clear();
+    EXPECT_EQ(cache.total_cost(), 0.);
+}
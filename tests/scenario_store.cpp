@@ -0,0 +1,116 @@
+#include <sstream>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "ExtTimingTag.hpp"
+#include "ScenarioStore.hpp"
+
+namespace {
+
+//Flattens the scenarios reachable from root into the (first) tag ids of each input
+std::vector<std::vector<TagId>> leaf_scenarios(const ScenarioStore& store, ScenarioId root) {
+    std::vector<std::vector<TagId>> scenarios;
+    store.for_each_scenario(root, [&](const ScenarioStore::Scenario& scenario) {
+        std::vector<TagId> tag_ids;
+        for(size_t i = 0; i < scenario.num_inputs(); ++i) {
+            tag_ids.push_back(scenario.alternative(i, 0));
+        }
+        scenarios.push_back(tag_ids);
+    });
+    return scenarios;
+}
+
+}
+
+TEST(ScenarioStore, UnionsPreserveScenarioOrder) {
+    ScenarioStore store;
+
+    std::vector<TagId> a = {1, 2};
+    std::vector<TagId> b = {3, 4};
+    std::vector<TagId> c = {5, 6};
+
+    ScenarioId root = INVALID_SCENARIO_ID;
+    root = store.make_union(root, store.make_leaf(a.data(), a.size()));
+    root = store.make_union(root, store.make_leaf(b.data(), b.size()));
+
+    //Merging another set of scenarios references it
+    ScenarioId other = store.make_leaf(c.data(), c.size());
+    root = store.make_union(root, other);
+
+    EXPECT_EQ(store.num_scenarios(root), 3u);
+    EXPECT_EQ(leaf_scenarios(store, root), std::vector<std::vector<TagId>>({a, b, c}));
+    EXPECT_EQ(store.num_scenarios(INVALID_SCENARIO_ID), 0u);
+}
+
+TEST(ScenarioStore, ProductsHoldAlternatives) {
+    ScenarioStore store;
+
+    ScenarioId root = store.make_product({{7, 8, 9}, {10}});
+
+    size_t num_scenarios = 0;
+    store.for_each_scenario(root, [&](const ScenarioStore::Scenario& scenario) {
+        ASSERT_EQ(scenario.num_inputs(), 2u);
+        EXPECT_EQ(scenario.num_alternatives(0), 3u);
+        EXPECT_EQ(scenario.alternative(0, 2), 9u);
+        EXPECT_EQ(scenario.num_alternatives(1), 1u);
+        EXPECT_EQ(scenario.alternative(1, 0), 10u);
+        ++num_scenarios;
+    });
+    EXPECT_EQ(num_scenarios, 1u);
+}
+
+TEST(ScenarioStore, MergedTagsReferenceScenarios) {
+    auto in_tag = ExtTimingTag::make_ptr(Time(1.), Time(NAN), 0, 0, TransitionType::RISE);
+    EXPECT_EQ(g_scenario_store.tag(in_tag->id()), in_tag);
+
+    TagId in_id = in_tag->id();
+    auto tag = ExtTimingTag::make_ptr(Time(2.), Time(NAN), 0, 0, TransitionType::RISE);
+    EXPECT_TRUE(tag->is_launch_tag());
+
+    tag->add_scenarios(g_scenario_store.make_leaf(&in_id, 1));
+    tag->add_scenarios(g_scenario_store.make_leaf(&in_id, 1));
+    EXPECT_FALSE(tag->is_launch_tag());
+    EXPECT_EQ(tag->num_scenarios(), 2u);
+}
+
+TEST(ScenarioStore, SameScenariosComparesContents) {
+    ScenarioStore store;
+
+    std::vector<TagId> a = {1, 2};
+    std::vector<TagId> b = {1, 3};
+    ScenarioId leaf_a = store.make_leaf(a.data(), a.size());
+    ScenarioId leaf_b = store.make_leaf(b.data(), b.size());
+
+    //Equivalent contents stored as different nodes
+    EXPECT_TRUE(store.same_scenarios(store.make_union(leaf_a, leaf_b), store.make_union(store.make_leaf(a.data(), a.size()), leaf_b)));
+    EXPECT_TRUE(store.same_scenarios(leaf_a, store.make_product({{1}, {2}})));
+    EXPECT_TRUE(store.same_scenarios(INVALID_SCENARIO_ID, INVALID_SCENARIO_ID));
+
+    EXPECT_FALSE(store.same_scenarios(leaf_a, leaf_b));
+    EXPECT_FALSE(store.same_scenarios(store.make_union(leaf_a, leaf_b), store.make_union(leaf_b, leaf_a)));
+    EXPECT_FALSE(store.same_scenarios(leaf_a, INVALID_SCENARIO_ID));
+}
+
+TEST(ScenarioStore, ReadRestoresWrittenIds) {
+    ScenarioStore store;
+
+    TagId in_id = store.allocate_tag();
+    *store.tag(in_id) = ExtTimingTag(Time(1.), Time(NAN), 0, 3, TransitionType::FALL);
+    std::vector<TagId> a = {in_id, in_id};
+    ScenarioId root = store.make_union(store.make_leaf(a.data(), a.size()), store.make_product({{in_id}, {in_id}}));
+
+    std::stringstream ss;
+    store.write(ss);
+
+    ScenarioStore restored;
+    restored.allocate_tag(); //Replaced
+    restored.read(ss);
+
+    ASSERT_EQ(restored.num_tags(), store.num_tags());
+    EXPECT_EQ(restored.tag(in_id)->launch_node(), 3);
+    EXPECT_EQ(restored.tag(in_id)->trans_type(), TransitionType::FALL);
+    EXPECT_EQ(restored.tag(in_id)->arr_time().value(), 1.);
+    EXPECT_EQ(restored.num_scenarios(root), 2u);
+    EXPECT_EQ(leaf_scenarios(restored, root), leaf_scenarios(store, root));
+}
@@ -0,0 +1,103 @@
+#include "gtest/gtest.h"
+
+#include "TimingGraph.hpp"
+#include "SharpSatBddEvaluator.hpp"
+
+namespace {
+
+//The evaluator only needs the analyzer type
+class NullAnalyzer {};
+
+typedef SharpSatBddEvaluator<NullAnalyzer> Evaluator;
+
+ExtTimingTag::cptr make_tag(std::vector<ExtTimingTag::cptr> src_tags) {
+    auto tag = ExtTimingTag::make_ptr(Time(1.), Time(NAN), 0, 0, TransitionType::RISE);
+
+    std::vector<TagId> src_ids;
+    for(auto src_tag : src_tags) {
+        src_ids.push_back(src_tag->id());
+    }
+    tag->add_scenarios(g_scenario_store.make_leaf(src_ids.data(), src_ids.size()));
+    return tag;
+}
+
+/*
+ * Two roots sharing a source (with reconvergent fanout from the inputs):
+ *
+ *   in0 --+--> shared --+--> root0
+ *   in1 --'             '--> root1
+ */
+class PlannedXfuncs : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            NodeId in0 = tg_.add_node(TN_Type::INPAD_SOURCE, 0, false);
+            NodeId in1 = tg_.add_node(TN_Type::INPAD_SOURCE, 0, false);
+            tg_.levelize();
+
+            eval_ = std::make_shared<Evaluator>(tg_, ConditionFunctionType::UNIFORM, 0, 2, InputVarOrder::NETLIST, std::vector<InputVar>(), nullptr);
+
+            auto launch0 = ExtTimingTag::make_ptr(Time(0.), Time(NAN), 0, in0, TransitionType::RISE);
+            auto launch1 = ExtTimingTag::make_ptr(Time(0.), Time(NAN), 0, in1, TransitionType::RISE);
+            shared_ = make_tag({launch0, launch1});
+            root0_ = make_tag({shared_});
+            root1_ = make_tag({shared_, launch0});
+        }
+
+        void TearDown() override {
+            g_scenario_store.clear();
+        }
+
+        TimingGraph tg_;
+        std::shared_ptr<Evaluator> eval_;
+        ExtTimingTag::cptr shared_;
+        ExtTimingTag::cptr root0_;
+        ExtTimingTag::cptr root1_;
+};
+
+}
+
+TEST_F(PlannedXfuncs, SourcesBuiltOncePerPlan) {
+    eval_->plan_xfuncs({root0_, root1_});
+
+    double frac0 = eval_->count_sat_fraction(root0_);
+    double frac1 = eval_->count_sat_fraction(root1_);
+
+    //The roots, the shared source and the two launch tags
+    EXPECT_EQ(eval_->num_xfuncs_built(), 5u);
+    EXPECT_DOUBLE_EQ(frac0, 1. / 16);
+    EXPECT_DOUBLE_EQ(frac1, 1. / 16);
+}
+
+TEST_F(PlannedXfuncs, RebuildAfterPlanReusesSources) {
+    eval_->plan_xfuncs({root0_, root1_});
+    eval_->count_sat_fraction(root0_);
+    eval_->count_sat_fraction(root1_);
+    eval_->end_plan();
+
+    //Rebuilding a root after the plan builds (and caches) its sources once
+    size_t num_built = eval_->num_xfuncs_built();
+    EXPECT_DOUBLE_EQ(eval_->count_sat_fraction(root0_), 1. / 16);
+    EXPECT_EQ(eval_->num_xfuncs_built(), num_built + 4);
+
+    //So building the other root, or the same root again, does not rebuild them
+    num_built = eval_->num_xfuncs_built();
+    EXPECT_DOUBLE_EQ(eval_->count_sat_fraction(root1_), 1. / 16);
+    EXPECT_EQ(eval_->num_xfuncs_built(), num_built + 1);
+
+    num_built = eval_->num_xfuncs_built();
+    EXPECT_DOUBLE_EQ(eval_->count_sat_fraction(root0_), 1. / 16);
+    EXPECT_EQ(eval_->num_xfuncs_built(), num_built);
+}
+
+TEST_F(PlannedXfuncs, ConsumedPlanReusesSources) {
+    eval_->plan_xfuncs({root0_, root1_});
+    eval_->count_sat_fraction(root0_);
+    eval_->count_sat_fraction(root1_);
+
+    //Without ending the plan, re-requested tags whose planned consumers are done are also cached
+    eval_->count_sat_fraction(root0_);
+    size_t num_built = eval_->num_xfuncs_built();
+    eval_->count_sat_fraction(root0_);
+    eval_->count_sat_fraction(root1_);
+    EXPECT_EQ(eval_->num_xfuncs_built(), num_built + 1);
+}
@@ -0,0 +1,73 @@
+#include <set>
+
+#include "gtest/gtest.h"
+
+#include "TagPermutationGenerator.hpp"
+
+namespace {
+
+std::vector<ExtTimingTags> make_input_tag_sets(const std::vector<size_t>& num_tags) {
+    std::vector<ExtTimingTags> input_tag_sets(num_tags.size());
+    for(size_t i = 0; i < num_tags.size(); ++i) {
+        for(size_t j = 0; j < num_tags[i]; ++j) {
+            input_tag_sets[i].add_tag(ExtTimingTag::make_ptr(Time(j), Time(NAN), 0, i, TransitionType::RISE));
+        }
+    }
+    return input_tag_sets;
+}
+
+}
+
+TEST(TagPermutationGenerator, EnumeratesAllPermutationsInGrayOrder) {
+    TagPermutationGenerator generator(make_input_tag_sets({3, 1, 4, 2}));
+
+    EXPECT_EQ(generator.num_permutations(), 24u);
+
+    std::set<std::vector<const ExtTimingTag*>> seen;
+    std::vector<const ExtTimingTag*> prev;
+    for(; !generator.done(); generator.advance()) {
+        const auto& perm = generator.current();
+        EXPECT_TRUE(seen.insert(perm).second);
+
+        if(!prev.empty()) {
+            //Exactly one input changes per step, and it is the one reported
+            size_t num_changed = 0;
+            for(size_t i = 0; i < perm.size(); ++i) {
+                if(perm[i] != prev[i]) {
+                    ++num_changed;
+                    EXPECT_EQ(generator.changed_input(), i);
+                }
+            }
+            EXPECT_EQ(num_changed, 1u);
+        }
+        prev = perm;
+    }
+    EXPECT_EQ(seen.size(), 24u);
+}
+
+TEST(TagPermutationGenerator, RandomAccessMatchesSequential) {
+    TagPermutationGenerator generator(make_input_tag_sets({2, 3, 3}));
+
+    std::vector<std::vector<const ExtTimingTag*>> sequential;
+    for(; !generator.done(); generator.advance()) {
+        sequential.push_back(generator.current());
+    }
+
+    for(size_t perm_idx = 0; perm_idx < sequential.size(); ++perm_idx) {
+        generator.seek(perm_idx);
+        EXPECT_EQ(generator.current(), sequential[perm_idx]);
+        EXPECT_EQ(generator.changed_input(), TagPermutationGenerator::ALL_INPUTS);
+    }
+
+    //Ranges cover the permutations exactly once
+    size_t perm_idx = 0;
+    for(size_t begin : {0, 5, 11}) {
+        size_t end = (begin == 0) ? 5 : (begin == 5) ? 11 : sequential.size();
+        generator.set_range(begin, end);
+        for(; !generator.done(); generator.advance()) {
+            EXPECT_EQ(generator.current(), sequential[perm_idx]);
+            ++perm_idx;
+        }
+    }
+    EXPECT_EQ(perm_idx, sequential.size());
+}
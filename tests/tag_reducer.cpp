@@ -0,0 +1,157 @@
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "TagReducer.hpp"
+
+namespace {
+
+//Coarse/fine bin sizes and slack threshold (ps)
+const double COARSE_BIN_SIZE = 1.;
+const double FINE_BIN_SIZE = 0.1;
+const double SLACK_THRESHOLD = 10.;
+const double REQ_TIME = 50.;
+
+/*
+ * Minimal analyzer providing the STA required time the reducer needs
+ */
+class TestStaTag {
+    public:
+        Time req_time() const { return Time(REQ_TIME); }
+};
+
+class TestStaTags {
+    public:
+        size_t num_tags() const { return 1; }
+        const TestStaTag* begin() const { return &tag_; }
+    private:
+        TestStaTag tag_;
+};
+
+class TestStaAnalyzer {
+    public:
+        TestStaTags setup_data_tags(NodeId /*node_id*/) const { return TestStaTags(); }
+};
+
+//The reference (linear search) merge: each tag is merged into the first already merged tag in the same bin
+Tags linear_merge_tags(const Tags& orig_tags, const double coarse_delay_bin_size, const double fine_delay_bin_size, const double arr_threshold) {
+    Tags merged_tags;
+
+    for(const auto& tag : orig_tags) {
+        auto bin_tag_pred = [&](Tags::Tag::cptr search_tag) {
+            if(tag->trans_type() != search_tag->trans_type()) return false;
+
+            if(tag->arr_time().value() > arr_threshold && search_tag->arr_time().value() <= arr_threshold) {
+                return false;
+            }
+
+            auto bin_size = coarse_delay_bin_size;
+            if(search_tag->arr_time().value() > arr_threshold) {
+                bin_size = fine_delay_bin_size;
+            }
+
+            double tag_bin = tag->arr_time().value();
+            double search_tag_bin = search_tag->arr_time().value();
+            if(bin_size != 0.) {
+                tag_bin = std::floor(tag_bin / bin_size);
+                search_tag_bin = std::floor(search_tag_bin / bin_size);
+            }
+            return tag_bin == search_tag_bin;
+        };
+
+        auto iter = std::find_if(merged_tags.begin(), merged_tags.end(), bin_tag_pred);
+        if(iter != merged_tags.end()) {
+            merged_tags.max_arr(iter, tag);
+        } else {
+            merged_tags.add_tag(tag);
+        }
+    }
+    return merged_tags;
+}
+
+//Tags with clustered arrival times (so many share bins, including the fine bins straddling the
+//threshold) each generated by its own scenario
+Tags make_tags(size_t num_tags, std::mt19937& rng) {
+    const TransitionType transitions[] = {TransitionType::RISE, TransitionType::FALL, TransitionType::HIGH, TransitionType::LOW};
+
+    std::uniform_int_distribution<int> step_dist(0, int(REQ_TIME / 0.05));
+    std::uniform_int_distribution<int> trans_dist(0, 3);
+    Tags tags;
+    for(size_t i = 0; i < num_tags; ++i) {
+        double arr = (i % 97 == 0) ? NAN : step_dist(rng) * 0.05;
+        auto tag = ExtTimingTag::make_ptr(Time(arr), Time(NAN), 0, i, transitions[trans_dist(rng)]);
+
+        TagId scenario_tag = i;
+        tag->add_scenarios(g_scenario_store.make_leaf(&scenario_tag, 1));
+        tags.add_tag(tag);
+    }
+    return tags;
+}
+
+//Merging modifies the merged tags, so each reducer merges its own copies
+Tags copy_tags(const Tags& tags) {
+    Tags tags_copy;
+    for(auto tag : tags) {
+        tags_copy.add_tag(ExtTimingTag::make_ptr(*tag));
+    }
+    return tags_copy;
+}
+
+//The (first) tag ids of each input of each scenario generating tag
+std::vector<std::vector<TagId>> tag_scenarios(ExtTimingTag::cptr tag) {
+    std::vector<std::vector<TagId>> scenarios;
+    g_scenario_store.for_each_scenario(tag->scenarios(), [&](const ScenarioStore::Scenario& scenario) {
+        std::vector<TagId> tag_ids;
+        for(size_t i = 0; i < scenario.num_inputs(); ++i) {
+            tag_ids.push_back(scenario.alternative(i, 0));
+        }
+        scenarios.push_back(tag_ids);
+    });
+    return scenarios;
+}
+
+}
+
+TEST(StaSlackTagReducer, MatchesLinearReference) {
+    StaSlackTagReducer<TestStaAnalyzer> reducer(std::make_shared<TestStaAnalyzer>(), SLACK_THRESHOLD, COARSE_BIN_SIZE, FINE_BIN_SIZE);
+
+    std::mt19937 rng(1);
+    for(size_t num_tags : {1, 10, 100, 1000, 5000}) {
+        Tags tags = make_tags(num_tags, rng);
+
+        for(double bin_size : {-1., 0., 0.5}) { //Default (coarse/fine) bins, no binning and a single bin size
+            Tags merged;
+            Tags expected;
+            if(bin_size < 0.) {
+                merged = reducer.merge_tags(0, copy_tags(tags));
+                expected = linear_merge_tags(copy_tags(tags), COARSE_BIN_SIZE, FINE_BIN_SIZE, REQ_TIME - SLACK_THRESHOLD);
+            } else {
+                merged = reducer.merge_tags(0, copy_tags(tags), bin_size);
+                expected = linear_merge_tags(copy_tags(tags), bin_size, bin_size, REQ_TIME - SLACK_THRESHOLD);
+                EXPECT_EQ(reducer.num_merged_tags(0, tags, bin_size), expected.num_tags());
+            }
+
+            ASSERT_EQ(merged.num_tags(), expected.num_tags()) << num_tags << " tags, bin size " << bin_size;
+            for(size_t i = 0; i < merged.num_tags(); ++i) {
+                auto tag = *(merged.begin() + i);
+                auto expected_tag = *(expected.begin() + i);
+
+                EXPECT_EQ(tag->trans_type(), expected_tag->trans_type());
+                double arr = tag->arr_time().value();
+                double expected_arr = expected_tag->arr_time().value();
+                if(std::isnan(expected_arr)) {
+                    EXPECT_TRUE(std::isnan(arr));
+                } else {
+                    EXPECT_EQ(arr, expected_arr);
+                }
+                EXPECT_EQ(tag->launch_node(), expected_tag->launch_node());
+                EXPECT_EQ(tag_scenarios(tag), tag_scenarios(expected_tag));
+            }
+        }
+
+        g_scenario_store.clear();
+    }
+}
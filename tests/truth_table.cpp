@@ -0,0 +1,42 @@
+#include "gtest/gtest.h"
+
+#include "truth_table.hpp"
+#include "transition_eval.hpp"
+
+TEST(TruthTable, CofactorsOfVariables) {
+    for(size_t var_idx = 0; var_idx < TRUTH_TABLE_MAX_VARS; ++var_idx) {
+        TruthTable var = tt_var(var_idx);
+        EXPECT_TRUE(tt_is_one(tt_cofactor(var, var_idx, true)));
+        EXPECT_TRUE(tt_is_zero(tt_cofactor(var, var_idx, false)));
+
+        //Other variables are unaffected
+        size_t other_idx = (var_idx + 1) % TRUTH_TABLE_MAX_VARS;
+        EXPECT_EQ(tt_cofactor(var, other_idx, true), var);
+        EXPECT_EQ(tt_cofactor(var, other_idx, false), var);
+    }
+}
+
+TEST(TruthTable, RestrictFiltersControlledInputs) {
+    //f = x0 & x1
+    TruthTable f = tt_var(0) & tt_var(1);
+
+    //A LOW input controls the AND, so the other input is filtered
+    TruthTable f_low = tt_restrict(f, 0, TransitionType::LOW);
+    EXPECT_TRUE(tt_is_zero(f_low));
+    EXPECT_EQ(tt_restrict(f_low, 1, TransitionType::RISE), f_low);
+
+    //A HIGH input does not
+    TruthTable f_high = tt_restrict(f, 0, TransitionType::HIGH);
+    EXPECT_EQ(f_high, tt_var(1));
+    EXPECT_TRUE(tt_is_one(tt_restrict(f_high, 1, TransitionType::RISE)));
+}
+
+TEST(TruthTable, EvaluateOutputTransition) {
+    //f = x0 ^ x1
+    TruthTable f = tt_var(0) ^ tt_var(1);
+
+    EXPECT_EQ(evaluate_output_transition({TransitionType::RISE, TransitionType::LOW}, f), TransitionType::RISE);
+    EXPECT_EQ(evaluate_output_transition({TransitionType::RISE, TransitionType::HIGH}, f), TransitionType::FALL);
+    EXPECT_EQ(evaluate_output_transition({TransitionType::RISE, TransitionType::RISE}, f), TransitionType::LOW);
+    EXPECT_EQ(evaluate_output_transition({TransitionType::HIGH, TransitionType::LOW}, f), TransitionType::HIGH);
+}
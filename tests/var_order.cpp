@@ -0,0 +1,104 @@
+#include <sstream>
+
+#include "gtest/gtest.h"
+
+#include "var_order.hpp"
+
+TEST(VarOrder, DfsOrdersInputsByFaninCone) {
+    //A deep cone and a shallow one
+    //
+    //  in2 -> b -> c -> out1
+    //  in0 -^      ^
+    //  in1 --------'
+    //  in3 -> out0
+    TimingGraph tg;
+    NodeId in0 = tg.add_node(TN_Type::INPAD_SOURCE, 0, false);
+    NodeId in1 = tg.add_node(TN_Type::INPAD_SOURCE, 0, false);
+    NodeId in2 = tg.add_node(TN_Type::INPAD_SOURCE, 0, false);
+    NodeId in3 = tg.add_node(TN_Type::INPAD_SOURCE, 0, false);
+    NodeId b = tg.add_node(TN_Type::PRIMITIVE_OPIN, 0, false);
+    NodeId c = tg.add_node(TN_Type::PRIMITIVE_OPIN, 0, false);
+    NodeId out0 = tg.add_node(TN_Type::OUTPAD_SINK, 0, false);
+    NodeId out1 = tg.add_node(TN_Type::OUTPAD_SINK, 0, false);
+
+    tg.add_edge(in3, out0);
+    tg.add_edge(in1, c);
+    tg.add_edge(in2, b);
+    tg.add_edge(in0, b);
+    tg.add_edge(b, c);
+    tg.add_edge(c, out1);
+    tg.levelize();
+
+    //The deepest output and fanins are walked first, ties in edge order
+    EXPECT_EQ(order_input_nodes(tg, InputVarOrder::DFS), std::vector<NodeId>({in2, in0, in1, in3}));
+
+    EXPECT_EQ(order_input_nodes(tg, InputVarOrder::NETLIST), std::vector<NodeId>({in0, in1, in2, in3}));
+}
+
+TEST(VarOrder, SavedOrderRoundTrips) {
+    std::vector<NamedInputVar> var_order = {{"b", "next"}, {"b", "curr"}, {"a", "curr"}, {"a", "next"}};
+
+    std::stringstream ss;
+    write_var_order(ss, var_order);
+
+    //Blank lines are ignored
+    ss << "\n";
+
+    EXPECT_EQ(read_var_order(ss), var_order);
+}
+
+namespace {
+
+//Two inputs' (curr, next) variables, keyed by node id
+struct InputVarsFixture {
+    std::vector<std::string> roles = {"curr", "next"};
+    std::vector<NodeId> default_order = {3, 5};
+    std::map<NodeId,std::vector<BDD>> input_vars = {
+        {3, {g_cudd.bddVar(0), g_cudd.bddVar(1)}},
+        {5, {g_cudd.bddVar(2), g_cudd.bddVar(3)}}
+    };
+
+    std::vector<BDD> vars(NodeId node_id, size_t first_role, size_t second_role) const {
+        return {input_vars.at(node_id)[first_role], input_vars.at(node_id)[second_role]};
+    }
+};
+
+}
+
+TEST(VarOrder, SavedOrderIgnoresExtraVars) {
+    InputVarsFixture f;
+
+    //An input no longer in the circuit, and an unknown role, in a saved order matching the default
+    std::vector<InputVar> saved_order = {{7, "curr"}, {3, "curr"}, {3, "prev"}, {3, "next"}, {7, "next"}, {5, "curr"}, {5, "next"}};
+
+    auto var_groups = order_input_var_groups(f.default_order, f.input_vars, f.roles, saved_order);
+
+    EXPECT_EQ(var_groups, std::vector<std::vector<BDD>>({f.vars(3, 0, 1), f.vars(5, 0, 1)}));
+}
+
+TEST(VarOrder, SavedOrderPlacesMissingVarsLast) {
+    InputVarsFixture f;
+
+    //Only input 5's next variable was saved: its curr variable follows it, and input 3 follows input 5
+    std::vector<InputVar> saved_order = {{5, "next"}};
+
+    auto var_groups = order_input_var_groups(f.default_order, f.input_vars, f.roles, saved_order);
+
+    EXPECT_EQ(var_groups, std::vector<std::vector<BDD>>({f.vars(5, 1, 0), f.vars(3, 0, 1)}));
+
+    //An empty saved order is the default order
+    var_groups = order_input_var_groups(f.default_order, f.input_vars, f.roles, std::vector<InputVar>());
+
+    EXPECT_EQ(var_groups, std::vector<std::vector<BDD>>({f.vars(3, 0, 1), f.vars(5, 0, 1)}));
+}
+
+TEST(VarOrder, SavedOrderKeepsSwappedRoles) {
+    InputVarsFixture f;
+
+    //Reordering may leave an input's next variable above its curr variable
+    std::vector<InputVar> saved_order = {{5, "next"}, {3, "curr"}, {3, "next"}, {5, "curr"}, {5, "next"}};
+
+    auto var_groups = order_input_var_groups(f.default_order, f.input_vars, f.roles, saved_order);
+
+    EXPECT_EQ(var_groups, std::vector<std::vector<BDD>>({f.vars(5, 1, 0), f.vars(3, 0, 1)}));
+}